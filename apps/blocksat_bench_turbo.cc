@@ -0,0 +1,386 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Blockstream Corp.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Turbo decoder throughput benchmark
+ *
+ * Encodes random datawords with the LTE turbo code (same codeword layout as
+ * the blocksattx turbo encoder), transmits them over a BPSK AWGN channel and
+ * decodes the LLRs with the codec pool used by the turbo_decoder block,
+ * outside of any flowgraph. Each combination of the swept parameters
+ * reports the decoded throughput, the latency of a single codeword, the BER,
+ * the FER and the average number of iterations.
+ */
+
+#include "turbo_codec.h"
+#include "Tools/types.h"
+#include "Module/Interleaver/LTE/Interleaver_LTE.hpp"
+#include "Module/Encoder/RSC/Encoder_RSC_generic_sys.hpp"
+#include "Module/Puncturer/Turbo/Puncturer_turbo.hpp"
+#include "Module/CRC/Polynomial/CRC_polynomial.hpp"
+#include <getopt.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace aff3ct;
+using namespace gr::blocksat;
+
+typedef std::chrono::steady_clock bench_clock;
+
+struct bench_opts {
+	std::vector<int> K;
+	std::vector<int> n_ite;
+	std::vector<int> pct_en;
+	std::vector<int> inter_frame;
+	std::vector<int> precision;
+	std::vector<int> n_threads;
+	std::vector<int> window_len;
+	std::vector<int> n_sub_blocks;
+	std::vector<int> radix4;
+	int training_len;
+	bool pack_bits;
+	float ebn0;
+	int n_codewords;
+	float min_time;
+	std::string crc;
+	std::string max_op;
+	float ext_scale;
+	bool hd_stop;
+	unsigned int seed;
+};
+
+static std::vector<int>
+parse_list(const char *arg)
+{
+	std::vector<int> list;
+	std::stringstream ss(arg);
+	std::string item;
+
+	while (std::getline(ss, item, ','))
+		list.push_back(std::stoi(item));
+
+	if (list.empty())
+		throw std::invalid_argument("empty list");
+
+	return list;
+}
+
+static void
+usage(const char *name)
+{
+	printf("Usage: %s [options]\n"
+	       "Lists are comma-separated and swept over all combinations.\n"
+	       "Set BLOCKSAT_SIMD (e.g. to sse4.1) to run a lower SIMD level.\n"
+	       "  -K list   Dataword lengths (default: 1024,6144)\n"
+	       "  -i list   Maximum iterations (default: 6)\n"
+	       "  -p list   Puncturing, 0 for rate 1/3, 1 for rate 1/2 "
+	       "(default: 0,1)\n"
+	       "  -s list   Inter-frame SIMD, 0 or 1 (default: 0,1)\n"
+	       "  -b list   LLR precision, 32 or 16 bits (default: 32,16)\n"
+	       "  -t list   Decoding threads (default: 1)\n"
+	       "  -w list   Sliding-window BCJR window, 0 for the whole trellis "
+	       "(default: 0)\n"
+	       "  -S list   Sub-blocks decoded in parallel per trellis "
+	       "(default: 1)\n"
+	       "  -R list   Radix-4 BCJR, 0 or 1 (default: 0)\n"
+	       "  -L len    Sliding-window BCJR training length (default: 32)\n"
+	       "  -P        Output the decoded bits packed 8 per byte\n"
+	       "  -e ebn0   Eb/N0 in dB (default: 1.5)\n"
+	       "  -n num    Codewords per measurement (default: 256)\n"
+	       "  -T sec    Minimum measurement time (default: 1.0)\n"
+	       "  -c crc    Early termination CRC, e.g. 24-LTEA (default: none)\n"
+	       "  -m op     BCJR max operator: max, max_star or max_linear "
+	       "(default: max)\n"
+	       "  -x scale  Extrinsic LLR scaling (default: 1.0)\n"
+	       "  -H        Stop once the hard decisions are stable\n"
+	       "  -r seed   Random seed (default: 1)\n"
+	       "  -h        Show this help\n", name);
+}
+
+/*
+ * Random datawords (with CRC if enabled) and the LLRs of their turbo
+ * codewords, as received over a BPSK AWGN channel
+ */
+static void
+make_codewords(int K, bool pct_en, const bench_opts &opts,
+               std::vector<float> &llrs, std::vector<unsigned char> &bits)
+{
+	const std::vector<int> poly = {013, 015};
+	const int tail_rsc = 6, tail = 2 * tail_rsc;
+	const int N_cw     = 3 * K + tail;
+	const int N        = (pct_en) ? ((K / 2) * 4 + tail) : N_cw;
+	const int n_cw     = opts.n_codewords;
+
+	module::Interleaver_LTE<int> pi(K);
+	pi.init();
+	module::Encoder_RSC_generic_sys<B_8> enc(K, 2 * K + tail_rsc, true, poly);
+	module::Puncturer_turbo<B_8,Q_8> *pct = NULL;
+	if (pct_en)
+		pct = new module::Puncturer_turbo<B_8,Q_8>(K, N, tail,
+		                                           {{1,1},{1,0},{0,1}}, true);
+	module::CRC_polynomial<B_8> *crc = NULL;
+	if (!opts.crc.empty())
+		crc = new module::CRC_polynomial<B_8>(
+			K - module::CRC_polynomial<B_8>::get_size(opts.crc), opts.crc);
+
+	std::mt19937 gen(opts.seed + K + (pct_en ? 1 : 0));
+	std::bernoulli_distribution bit_dist;
+	std::normal_distribution<float> noise_dist;
+
+	const float rate  = (float)K / N;
+	const float sigma = std::sqrt(1.0f / (2.0f * rate *
+	                                      std::pow(10.0f, opts.ebn0 / 10.0f)));
+
+	std::vector<B_8> u(K), u_i(K), x_n(2 * K + tail_rsc), x_i(2 * K + tail_rsc);
+	std::vector<B_8> x(N_cw), x_pct(N);
+	llrs.resize(n_cw * N);
+	bits.resize(n_cw * K);
+
+	for (int f = 0; f < n_cw; f++) {
+		for (int i = 0; i < K; i++)
+			u[i] = bit_dist(gen);
+		if (crc) {
+			std::vector<B_8> info(u.begin(), u.begin() + crc->get_K());
+			crc->build(info.data(), u.data());
+		}
+		std::copy(u.begin(), u.end(), bits.begin() + f * K);
+
+		/* Codeword: systematic, parity 1, parity 2, tail 1, tail 2 */
+		pi.interleave(u.data(), u_i.data(), 0);
+		enc.encode(u.data(), x_n.data());
+		enc.encode(u_i.data(), x_i.data());
+		std::copy(x_n.begin(),         x_n.begin() + 2 * K, x.begin());
+		std::copy(x_i.begin() + K,     x_i.begin() + 2 * K, x.begin() + 2 * K);
+		std::copy(x_n.begin() + 2 * K, x_n.end(),           x.begin() + 3 * K);
+		std::copy(x_i.begin() + 2 * K, x_i.end(),           x.begin() + 3 * K + tail_rsc);
+
+		const B_8 *tx = x.data();
+		if (pct) {
+			pct->puncture(x.data(), x_pct.data());
+			tx = x_pct.data();
+		}
+
+		/* BPSK (bit 0 -> +1) and LLR = 2y/sigma^2 */
+		for (int i = 0; i < N; i++) {
+			float y = (tx[i] ? -1.0f : 1.0f) + sigma * noise_dist(gen);
+			llrs[f * N + i] = 2.0f * y / (sigma * sigma);
+		}
+	}
+
+	delete pct;
+	delete crc;
+}
+
+static void
+run_config(int K, int n_ite, bool pct_en, bool inter_frame, int precision,
+           int n_threads, int window_len, int n_sub_blocks, bool radix4,
+           const bench_opts &opts, const std::vector<float> &llrs,
+           const std::vector<unsigned char> &bits)
+{
+	printf("%5d %4d %4s %5s %4d %4d %4d %4d %5s ", K, n_ite,
+	       pct_en ? "1/2" : "1/3", inter_frame ? "inter" : "intra",
+	       precision, n_threads, window_len, n_sub_blocks,
+	       radix4 ? "4" : "2");
+	fflush(stdout);
+
+	TurboCodecPool *pool;
+	try {
+		pool = new TurboCodecPool(n_threads, K, pct_en, n_ite, false,
+		                          inter_frame, precision, opts.crc,
+		                          window_len, opts.training_len,
+		                          n_sub_blocks, radix4, opts.pack_bits,
+		                          opts.max_op, opts.ext_scale, opts.hd_stop);
+	} catch (const std::exception &e) {
+		printf("skipped (%s)\n", e.what());
+		return;
+	}
+
+	const int n_cw = opts.n_codewords;
+	const int N       = pool->get_N();
+	const int out_len = pool->get_out_len();
+	std::vector<unsigned char> out(n_cw * out_len);
+	turbo_codec_stats stats;
+	stats.ite_hist.assign(n_ite + 1, 0);
+	stats.n_failures  = 0;
+	stats.time_sum_ns = 0;
+	stats.time_max_ns = 0;
+
+	/* Throughput: decode the whole set until the minimum time elapses */
+	int n_runs = 0;
+	double t_total = 0;
+	do {
+		auto t0 = bench_clock::now();
+		pool->decode(llrs.data(), out.data(), n_cw);
+		t_total += std::chrono::duration<double>(bench_clock::now() - t0).count();
+		n_runs++;
+	} while (t_total < opts.min_time);
+
+	uint64_t n_bit_err = 0, n_fr_err = 0;
+	for (int f = 0; f < n_cw; f++) {
+		int err = 0;
+		const unsigned char *cw = out.data() + f * out_len;
+		for (int i = 0; i < K; i++) {
+			const int bit = (opts.pack_bits) ?
+			                ((cw[i / 8] >> (7 - i % 8)) & 1) : cw[i];
+			err += (bit != bits[f * K + i]);
+		}
+		n_bit_err += err;
+		n_fr_err  += (err > 0);
+	}
+
+	pool->collect_stats(stats);
+	uint64_t n_dec = 0, n_ite_used = 0;
+	for (int i = 0; i <= n_ite; i++) {
+		n_dec      += stats.ite_hist[i];
+		n_ite_used += i * stats.ite_hist[i];
+	}
+
+	/* Latency: decode one codeword at a time (a partial batch in
+	 * inter-frame mode) */
+	const int n_lat = std::min(n_cw, 32);
+	double t_lat = 0;
+	for (int f = 0; f < n_lat; f++) {
+		auto t0 = bench_clock::now();
+		pool->decode(llrs.data() + f * N, out.data(), 1);
+		t_lat += std::chrono::duration<double>(bench_clock::now() - t0).count();
+	}
+
+	printf("%6s %9.2f %9.1f %10.3e %10.3e %6.2f\n",
+	       pool->get_simd_level().c_str(),
+	       ((double)n_runs * n_cw * K) / t_total / 1e6,
+	       t_lat / n_lat * 1e6,
+	       (double)n_bit_err / ((double)n_cw * K),
+	       (double)n_fr_err / n_cw,
+	       (n_dec > 0) ? ((double)n_ite_used / n_dec) : 0.0);
+
+	delete pool;
+}
+
+int
+main(int argc, char **argv)
+{
+	bench_opts opts;
+	opts.K            = {1024, 6144};
+	opts.n_ite        = {6};
+	opts.pct_en       = {0, 1};
+	opts.inter_frame  = {0, 1};
+	opts.precision    = {32, 16};
+	opts.n_threads    = {1};
+	opts.window_len   = {0};
+	opts.n_sub_blocks = {1};
+	opts.radix4       = {0};
+	opts.training_len = 32;
+	opts.pack_bits    = false;
+	opts.ebn0         = 1.5;
+	opts.n_codewords  = 256;
+	opts.min_time     = 1.0;
+	opts.max_op       = "max";
+	opts.ext_scale    = 1.0;
+	opts.hd_stop      = false;
+	opts.seed         = 1;
+
+	int opt;
+	try {
+		while ((opt = getopt(argc, argv, "K:i:p:s:b:t:w:S:R:L:Pe:n:T:c:m:x:Hr:h")) != -1) {
+			switch (opt) {
+			case 'K': opts.K            = parse_list(optarg); break;
+			case 'i': opts.n_ite        = parse_list(optarg); break;
+			case 'p': opts.pct_en       = parse_list(optarg); break;
+			case 's': opts.inter_frame  = parse_list(optarg); break;
+			case 'b': opts.precision    = parse_list(optarg); break;
+			case 't': opts.n_threads    = parse_list(optarg); break;
+			case 'w': opts.window_len   = parse_list(optarg); break;
+			case 'S': opts.n_sub_blocks = parse_list(optarg); break;
+			case 'R': opts.radix4       = parse_list(optarg); break;
+			case 'L': opts.training_len = std::stoi(optarg); break;
+			case 'P': opts.pack_bits    = true; break;
+			case 'e': opts.ebn0         = std::stof(optarg); break;
+			case 'n': opts.n_codewords  = std::stoi(optarg); break;
+			case 'T': opts.min_time     = std::stof(optarg); break;
+			case 'c': opts.crc          = optarg; break;
+			case 'm': opts.max_op       = optarg; break;
+			case 'x': opts.ext_scale    = std::stof(optarg); break;
+			case 'H': opts.hd_stop      = true; break;
+			case 'r': opts.seed         = std::stoul(optarg); break;
+			case 'h':
+				usage(argv[0]);
+				return 0;
+			default:
+				usage(argv[0]);
+				return 1;
+			}
+		}
+	} catch (const std::exception &e) {
+		fprintf(stderr, "Invalid argument for -%c: %s\n", opt, optarg);
+		return 1;
+	}
+
+	if (opts.n_codewords < 1) {
+		fprintf(stderr, "The number of codewords must be >= 1\n");
+		return 1;
+	}
+
+	printf("SIMD level: %s, Eb/N0 = %.2f dB, %d codewords per measurement, "
+	       "CRC: %s, max operator: %s, extrinsic scaling: %.2f, "
+	       "stable HD stop: %s, training length: %d, packed output: %s\n\n",
+	       turbo_codec_simd_level().c_str(), opts.ebn0, opts.n_codewords,
+	       opts.crc.empty() ? "none" : opts.crc.c_str(), opts.max_op.c_str(),
+	       opts.ext_scale, opts.hd_stop ? "yes" : "no", opts.training_len,
+	       opts.pack_bits ? "yes" : "no");
+	printf("%5s %4s %4s %5s %4s %4s %4s %4s %5s %6s %9s %9s %10s %10s "
+	       "%6s\n", "K", "ite", "rate", "simd", "prec", "thr", "win", "sub",
+	       "radix", "level", "Mbit/s", "lat (us)", "BER", "FER", "ite");
+
+	for (int K : opts.K) {
+		for (int pct_en : opts.pct_en) {
+			std::vector<float> llrs;
+			std::vector<unsigned char> bits;
+			try {
+				make_codewords(K, pct_en, opts, llrs, bits);
+			} catch (const std::exception &e) {
+				printf("K = %d: %s\n", K, e.what());
+				continue;
+			}
+
+			for (int n_ite : opts.n_ite)
+				for (int inter_frame : opts.inter_frame)
+					for (int precision : opts.precision)
+						for (int n_threads : opts.n_threads)
+							for (int window_len : opts.window_len)
+								for (int n_sub_blocks : opts.n_sub_blocks)
+									for (int radix4 : opts.radix4)
+										run_config(K, n_ite, pct_en,
+										           inter_frame, precision,
+										           n_threads, window_len,
+										           n_sub_blocks, radix4,
+										           opts, llrs, bits);
+		}
+	}
+
+	return 0;
+}
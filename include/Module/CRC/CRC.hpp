@@ -0,0 +1,89 @@
+/*!
+ * \file
+ * \brief Adds/builds and checks a Cyclic Redundancy Check (CRC) for a set of information bits.
+ *
+ * \section LICENSE
+ * This file is under MIT license (https://opensource.org/licenses/MIT).
+ */
+#ifndef CRC_HPP_
+#define CRC_HPP_
+
+#include <string>
+#include <vector>
+
+#include "Module/Module.hpp"
+
+namespace aff3ct
+{
+namespace module
+{
+
+/*!
+ * \class CRC
+ *
+ * \brief Adds/builds and checks a Cyclic Redundancy Check (CRC) for a set of information bits.
+ *
+ * \tparam B: type of the bits in the CRC.
+ *
+ * The CRC bits are located at the end of the frame: a frame holds CRC::K information bits followed by
+ * CRC::get_size() CRC bits.
+ */
+template <typename B = int>
+class CRC : public Module
+{
+protected:
+	const int K; /*!< Number of information bits (the CRC bits are not included in K) */
+
+public:
+	/*!
+	 * \brief Constructor.
+	 *
+	 * \param K:        number of information bits (the CRC bits are not included in K).
+	 * \param n_frames: number of frames to process in the CRC.
+	 */
+	CRC(const int K, const int n_frames = 1);
+
+	/*!
+	 * \brief Destructor.
+	 */
+	virtual ~CRC() = default;
+
+	int get_K() const;
+
+	/*!
+	 * \brief Gets the size of the CRC (the number of bits for the CRC signature).
+	 *
+	 * \return the size of the CRC.
+	 */
+	virtual int get_size() = 0;
+
+	/*!
+	 * \brief Computes and adds the CRC in the vector of information bits (the CRC bits are often put at the end of
+	 *        the vector).
+	 *
+	 * \param U_K1: a vector (size = K) containing the information bits.
+	 * \param U_K2: a vector (size = K + get_size()) containing the information bits and the CRC bits.
+	 */
+	virtual void build(const B *U_K1, B *U_K2, const int frame_id = -1);
+
+	/*!
+	 * \brief Checks if the CRC is verified or not.
+	 *
+	 * \param V_K:      a vector (size = K + get_size()) containing the decoded information bits and the CRC bits.
+	 * \param n_frames: you should not use this parameter unless you know what you are doing, this parameter
+	 *                  redefine the number of frames to check specifically in this method.
+	 *
+	 * \return true if the CRC is verified, false otherwise.
+	 */
+	virtual bool check(const B *V_K, const int n_frames = -1, const int frame_id = -1);
+
+protected:
+	virtual void _build(const B *U_K1, B *U_K2, const int frame_id);
+
+	virtual bool _check(const B *V_K, const int frame_id);
+};
+}
+}
+#include "CRC.hxx"
+
+#endif /* CRC_HPP_ */
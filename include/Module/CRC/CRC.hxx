@@ -0,0 +1,95 @@
+/*!
+ * \file
+ * \brief Adds/builds and checks a Cyclic Redundancy Check (CRC) for a set of information bits.
+ *
+ * \section LICENSE
+ * This file is under MIT license (https://opensource.org/licenses/MIT).
+ */
+#ifndef CRC_HXX_
+#define CRC_HXX_
+
+#include <sstream>
+#include "Tools/Exception/exception.hpp"
+
+#include "CRC.hpp"
+
+namespace aff3ct
+{
+namespace module
+{
+
+template <typename B>
+CRC<B>::
+CRC(const int K, const int n_frames)
+: Module(n_frames), K(K)
+{
+	if (K <= 0)
+	{
+		std::stringstream message;
+		message << "'K' has to be greater than 0 ('K' = " << K << ").";
+		throw tools::invalid_argument(__FILE__, __LINE__, __func__, message.str());
+	}
+}
+
+template <typename B>
+int CRC<B>::
+get_K() const
+{
+	return K;
+}
+
+template <typename B>
+void CRC<B>::
+build(const B *U_K1, B *U_K2, const int frame_id)
+{
+	const auto f_start = (frame_id < 0) ? 0 : frame_id % this->n_frames;
+	const auto f_stop  = (frame_id < 0) ? this->n_frames : f_start +1;
+
+	for (auto f = f_start; f < f_stop; f++)
+		this->_build(U_K1 + f *  this->K,
+		             U_K2 + f * (this->K + this->get_size()),
+		             f);
+}
+
+template <typename B>
+bool CRC<B>::
+check(const B *V_K, const int n_frames, const int frame_id)
+{
+	if (n_frames <= 0 && n_frames != -1)
+	{
+		std::stringstream message;
+		message << "'n_frames' has to be greater than 0 or equal to -1 ('n_frames' = " << n_frames << ").";
+		throw tools::invalid_argument(__FILE__, __LINE__, __func__, message.str());
+	}
+
+	const int real_n_frames = (n_frames != -1) ? n_frames : this->n_frames;
+
+	const auto f_start = (frame_id < 0) ? 0 : frame_id % real_n_frames;
+	const auto f_stop  = (frame_id < 0) ? real_n_frames : f_start +1;
+
+	for (auto f = f_start; f < f_stop; f++)
+		if (!this->_check(V_K + f * (this->K + this->get_size()), f))
+			return false;
+
+	return true;
+}
+
+template <typename B>
+void CRC<B>::
+_build(const B *U_K1, B *U_K2, const int frame_id)
+{
+	throw tools::unimplemented_error(__FILE__, __LINE__, __func__);
+}
+
+template <typename B>
+bool CRC<B>::
+_check(const B *V_K, const int frame_id)
+{
+	throw tools::unimplemented_error(__FILE__, __LINE__, __func__);
+	return false;
+}
+
+}
+}
+
+#endif /* CRC_HXX_ */
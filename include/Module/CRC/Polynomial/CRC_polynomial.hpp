@@ -0,0 +1,52 @@
+#ifndef CRC_POLYNOMIAL_HPP_
+#define CRC_POLYNOMIAL_HPP_
+
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "../CRC.hpp"
+
+namespace aff3ct
+{
+namespace module
+{
+/*!
+ * \class CRC_polynomial
+ *
+ * \brief CRC defined by a generator polynomial (MSB first, all-zero initial register, no final XOR).
+ *
+ * The CRC is computed one byte at a time with a lookup table.
+ */
+template <typename B = int>
+class CRC_polynomial : public CRC<B>
+{
+protected:
+	static const std::map<std::string, std::tuple<unsigned, int>> known_polynomials;
+
+	const unsigned   polynomial;
+	const int        size;
+	const unsigned   mask;
+	std::vector<unsigned> lut;
+
+public:
+	CRC_polynomial(const int K, std::string poly_key, const int size = 0, const int n_frames = 1);
+	virtual ~CRC_polynomial() = default;
+
+	int get_size();
+
+	static int         get_size (std::string poly_key);
+	static std::string get_name (std::string poly_key);
+	static unsigned    get_value(std::string poly_key);
+
+protected:
+	unsigned compute(const B *U_K) const;
+
+	virtual void _build(const B *U_K1, B *U_K2, const int frame_id);
+	virtual bool _check(const B *V_K,           const int frame_id);
+};
+}
+}
+
+#endif /* CRC_POLYNOMIAL_HPP_ */
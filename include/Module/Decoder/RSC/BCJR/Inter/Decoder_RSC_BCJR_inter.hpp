@@ -0,0 +1,32 @@
+#ifndef DECODER_RSC_BCJR_INTER_HPP_
+#define DECODER_RSC_BCJR_INTER_HPP_
+
+#include <vector>
+#include <mipp/mipp.h>
+
+#include "../Decoder_RSC_BCJR.hpp"
+
+namespace aff3ct
+{
+namespace module
+{
+template <typename B = int, typename R = float>
+class Decoder_RSC_BCJR_inter : public Decoder_RSC_BCJR<B,R>
+{
+protected:
+	mipp::vector<R> alpha[8]; // node metric (left to right)
+	mipp::vector<R> gamma[2]; // edge metric
+
+	Decoder_RSC_BCJR_inter(const int &K,
+	                       const std::vector<std::vector<int>> &trellis,
+	                       const bool buffered_encoding = true,
+	                       const int n_frames = mipp::nElReg<R>(),
+	                       const std::string name = "Decoder_RSC_BCJR_inter");
+	virtual ~Decoder_RSC_BCJR_inter();
+};
+}
+}
+
+#include "Decoder_RSC_BCJR_inter.hxx"
+
+#endif /* DECODER_RSC_BCJR_INTER_HPP_ */
@@ -0,0 +1,206 @@
+#include <limits>
+#include <sstream>
+
+#include "Tools/Exception/exception.hpp"
+#include "Tools/Math/utils.h"
+
+#include "Decoder_RSC_BCJR_inter.hpp"
+
+namespace aff3ct
+{
+namespace module
+{
+template <typename R>
+struct RSC_BCJR_inter_init
+{
+	static R init_val()
+	{
+		return -std::numeric_limits<R>::max();
+	}
+};
+
+template <>
+struct RSC_BCJR_inter_init <short>
+{
+	static short init_val()
+	{
+		return -(1 << (sizeof(short) * 8 -2));
+	}
+};
+
+template <>
+struct RSC_BCJR_inter_init <signed char>
+{
+	static signed char init_val()
+	{
+		return -63;
+	}
+};
+
+template <typename B, typename R>
+Decoder_RSC_BCJR_inter<B,R>
+::Decoder_RSC_BCJR_inter(const int &K,
+                         const std::vector<std::vector<int>> &trellis,
+                         const bool buffered_encoding,
+                         const int n_frames,
+                         const std::string name)
+: Decoder_RSC_BCJR<B,R>(K, trellis, buffered_encoding, n_frames, mipp::nElReg<R>(), name)
+{
+	std::vector<std::vector<int>> req_trellis(10, std::vector<int>(8));
+	req_trellis[0] = { 0,  2,  4,  6,  0,  2,  4,  6};
+	req_trellis[1] = { 1, -1,  1, -1, -1,  1, -1,  1};
+	req_trellis[2] = { 0,  1,  1,  0,  0,  1,  1,  0};
+	req_trellis[3] = { 1,  3,  5,  7,  1,  3,  5,  7};
+	req_trellis[4] = {-1,  1, -1,  1,  1, -1,  1, -1};
+	req_trellis[5] = { 0,  1,  1,  0,  0,  1,  1,  0};
+	req_trellis[6] = { 0,  4,  5,  1,  2,  6,  7,  3};
+	req_trellis[7] = { 0,  0,  1,  1,  1,  1,  0,  0};
+	req_trellis[8] = { 4,  0,  1,  5,  6,  2,  3,  7};
+	req_trellis[9] = { 0,  0,  1,  1,  1,  1,  0,  0};
+
+	for (unsigned i = 0; i < req_trellis.size(); i++)
+		if (trellis[i] != req_trellis[i])
+			throw tools::invalid_argument(__FILE__, __LINE__, __func__, "Unsupported trellis.");
+
+	if (n_frames % mipp::nElReg<R>())
+	{
+		std::stringstream message;
+		message << "'n_frames' has to be divisible by 'mipp::nElReg<R>()' ('n_frames' = " << n_frames
+		        << ", 'mipp::nElReg<R>()' = " << mipp::nElReg<R>() << ").";
+		throw tools::invalid_argument(__FILE__, __LINE__, __func__, message.str());
+	}
+
+	constexpr auto n_lanes = mipp::nElReg<R>();
+	for (auto i = 0; i < 8; i++) alpha[i].resize((K +4) * n_lanes);
+	for (auto i = 0; i < 2; i++) gamma[i].resize((K +3) * n_lanes);
+
+	// init alpha values (the state 0 is the only valid initial state)
+	for (auto f = 0; f < n_lanes; f++)
+	{
+		alpha[0][f] = (R)0;
+		for (auto i = 1; i < 8; i++)
+			alpha[i][f] = RSC_BCJR_inter_init<R>::init_val();
+	}
+}
+
+template <typename B, typename R>
+Decoder_RSC_BCJR_inter<B,R>
+::~Decoder_RSC_BCJR_inter()
+{
+}
+
+// =================================================================================================== sys/par division
+template <typename R>
+struct RSC_BCJR_inter_div_or_not
+{
+	static mipp::Reg<R> apply(const mipp::Reg<R> m)
+	{
+		return mipp::div2(m);
+	}
+};
+
+template <>
+struct RSC_BCJR_inter_div_or_not <short>
+{
+	static mipp::Reg<short> apply(const mipp::Reg<short> m)
+	{
+		// (WW) work only for max-log-MAP !!!
+		return m;
+	}
+};
+
+template <>
+struct RSC_BCJR_inter_div_or_not <signed char>
+{
+	static mipp::Reg<signed char> apply(const mipp::Reg<signed char> m)
+	{
+		// gamma in [-31, 31] and the normalized metrics in [-63, 0]: the metrics update cannot overflow
+		return mipp::sat(mipp::div2(m), (signed char)-31, (signed char)31);
+	}
+};
+
+// ====================================================================================================== post division
+template <typename R>
+struct RSC_BCJR_inter_post
+{
+	static mipp::Reg<R> add(const mipp::Reg<R> alpha, const mipp::Reg<R> beta)
+	{
+		return alpha + beta;
+	}
+
+	static mipp::Reg<R> compute(const mipp::Reg<R> max0, const mipp::Reg<R> max1)
+	{
+		return max0 - max1;
+	}
+};
+
+template <>
+struct RSC_BCJR_inter_post <short>
+{
+	static mipp::Reg<short> add(const mipp::Reg<short> alpha, const mipp::Reg<short> beta)
+	{
+		return alpha + beta;
+	}
+
+	static mipp::Reg<short> compute(const mipp::Reg<short> max0, const mipp::Reg<short> max1)
+	{
+		// (WW) work only for max-log-MAP !!!
+		return mipp::div2(max0 - max1);
+	}
+};
+
+template <>
+struct RSC_BCJR_inter_post <signed char>
+{
+	static mipp::Reg<signed char> add(const mipp::Reg<signed char> alpha, const mipp::Reg<signed char> beta)
+	{
+		// the metrics are normalized to [-63, 0]: saturate the sum such that alpha + beta + gamma cannot overflow
+		return mipp::sat(alpha + beta, (signed char)-63, (signed char)0);
+	}
+
+	static mipp::Reg<signed char> compute(const mipp::Reg<signed char> max0, const mipp::Reg<signed char> max1)
+	{
+		return mipp::sat(max0 - max1, (signed char)-63, (signed char)63);
+	}
+};
+
+// ====================================================================================================== normalization
+template <typename R>
+struct RSC_BCJR_inter_normalize
+{
+	static void apply(mipp::Reg<R> metrics[8], const int &i)
+	{
+		// no need to do something
+	}
+};
+
+template <>
+struct RSC_BCJR_inter_normalize <short>
+{
+	static void apply(mipp::Reg<short> metrics[8], const int &i)
+	{
+		// normalization
+		if (i % 8 == 0)
+		{
+			const auto norm_val = metrics[0];
+			for (auto j = 0; j < 8; j++)
+				metrics[j] = metrics[j] - norm_val;
+		}
+	}
+};
+
+template <>
+struct RSC_BCJR_inter_normalize <signed char>
+{
+	static void apply(mipp::Reg<signed char> metrics[8], const int &i)
+	{
+		// normalization (on the biggest metric, all the metrics become negative) & saturation
+		auto norm_val = mipp::max(metrics[0], metrics[1]);
+		for (auto j = 2; j < 8; j++)
+			norm_val = mipp::max(norm_val, metrics[j]);
+		for (auto j = 0; j < 8; j++)
+			metrics[j] = mipp::sat(metrics[j] - norm_val, (signed char)-63, (signed char)63);
+	}
+};
+}
+}
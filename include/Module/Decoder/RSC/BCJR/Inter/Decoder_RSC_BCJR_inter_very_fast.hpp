@@ -0,0 +1,44 @@
+#ifndef DECODER_RSC_BCJR_INTER_VERY_FAST_HPP_
+#define DECODER_RSC_BCJR_INTER_VERY_FAST_HPP_
+
+#include <vector>
+#include <mipp/mipp.h>
+
+#include "Tools/Math/max.h"
+
+#include "Decoder_RSC_BCJR_inter.hpp"
+
+namespace aff3ct
+{
+namespace module
+{
+/*!
+ * \class Decoder_RSC_BCJR_inter_very_fast
+ *
+ * \brief BCJR decoder of the {013, 015} RSC code working on mipp::nElReg<R>() frames at once (one frame per SIMD
+ *        lane). The frames have to be reordered first (see tools::Reorderer).
+ */
+template <typename B = int, typename R = float, tools::proto_max_i<R> MAX = tools::max_i>
+class Decoder_RSC_BCJR_inter_very_fast : public Decoder_RSC_BCJR_inter<B,R>
+{
+public:
+	Decoder_RSC_BCJR_inter_very_fast(const int &K,
+	                                 const std::vector<std::vector<int>> &trellis,
+	                                 const bool buffered_encoding = true,
+	                                 const int n_frames = mipp::nElReg<R>(),
+	                                 const std::string name = "Decoder_RSC_BCJR_inter_very_fast");
+	virtual ~Decoder_RSC_BCJR_inter_very_fast();
+
+protected:
+	void _decode_siso(const R *sys, const R *par, R *ext, const int frame_id);
+
+	virtual void compute_gamma   (const R *sys, const R *par);
+	virtual void compute_alpha   (                          );
+	virtual void compute_beta_ext(const R *sys,       R *ext);
+};
+}
+}
+
+#include "Decoder_RSC_BCJR_inter_very_fast.hxx"
+
+#endif /* DECODER_RSC_BCJR_INTER_VERY_FAST_HPP_ */
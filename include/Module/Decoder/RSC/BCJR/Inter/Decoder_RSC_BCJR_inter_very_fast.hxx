@@ -0,0 +1,153 @@
+#include "Decoder_RSC_BCJR_inter_very_fast.hpp"
+
+namespace aff3ct
+{
+namespace module
+{
+template <typename B, typename R, tools::proto_max_i<R> MAX>
+Decoder_RSC_BCJR_inter_very_fast<B,R,MAX>
+::Decoder_RSC_BCJR_inter_very_fast(const int &K,
+                                   const std::vector<std::vector<int>> &trellis,
+                                   const bool buffered_encoding,
+                                   const int n_frames,
+                                   const std::string name)
+: Decoder_RSC_BCJR_inter<B,R>(K, trellis, buffered_encoding, n_frames, name)
+{
+}
+
+template <typename B, typename R, tools::proto_max_i<R> MAX>
+Decoder_RSC_BCJR_inter_very_fast<B,R,MAX>
+::~Decoder_RSC_BCJR_inter_very_fast()
+{
+}
+
+template <typename B, typename R, tools::proto_max_i<R> MAX>
+void Decoder_RSC_BCJR_inter_very_fast<B,R,MAX>
+::compute_gamma(const R *sys, const R *par)
+{
+	constexpr auto n = mipp::nElReg<R>();
+
+	// compute gamma values (one frame per SIMD lane)
+	for (auto i = 0; i < (this->K +3) * n; i += n)
+	{
+		const auto r_sys = mipp::Reg<R>(&sys[i]);
+		const auto r_par = mipp::Reg<R>(&par[i]);
+
+		RSC_BCJR_inter_div_or_not<R>::apply(r_sys + r_par).store(&this->gamma[0][i]);
+		RSC_BCJR_inter_div_or_not<R>::apply(r_sys - r_par).store(&this->gamma[1][i]);
+	}
+}
+
+template <typename B, typename R, tools::proto_max_i<R> MAX>
+void Decoder_RSC_BCJR_inter_very_fast<B,R,MAX>
+::compute_alpha()
+{
+	constexpr auto n = mipp::nElReg<R>();
+
+	mipp::Reg<R> r_a[8];
+	for (auto j = 0; j < 8; j++)
+		r_a[j] = mipp::Reg<R>(&this->alpha[j][0]);
+
+	// compute alpha values [trellis forward traversal ->]
+	for (auto i = 1; i < this->K +3; i++)
+	{
+		const auto g0 = mipp::Reg<R>(&this->gamma[0][(i -1) * n]);
+		const auto g1 = mipp::Reg<R>(&this->gamma[1][(i -1) * n]);
+
+		mipp::Reg<R> r_a_cur[8];
+		r_a_cur[0] = MAX(r_a[0] + g0, r_a[1] - g0);
+		r_a_cur[1] = MAX(r_a[3] + g1, r_a[2] - g1);
+		r_a_cur[2] = MAX(r_a[4] + g1, r_a[5] - g1);
+		r_a_cur[3] = MAX(r_a[7] + g0, r_a[6] - g0);
+		r_a_cur[4] = MAX(r_a[1] + g0, r_a[0] - g0);
+		r_a_cur[5] = MAX(r_a[2] + g1, r_a[3] - g1);
+		r_a_cur[6] = MAX(r_a[5] + g1, r_a[4] - g1);
+		r_a_cur[7] = MAX(r_a[6] + g0, r_a[7] - g0);
+
+		RSC_BCJR_inter_normalize<R>::apply(r_a_cur, i);
+
+		for (auto j = 0; j < 8; j++)
+		{
+			r_a[j] = r_a_cur[j];
+			r_a[j].store(&this->alpha[j][i * n]);
+		}
+	}
+}
+
+template <typename B, typename R, tools::proto_max_i<R> MAX>
+void Decoder_RSC_BCJR_inter_very_fast<B,R,MAX>
+::compute_beta_ext(const R *sys, R *ext)
+{
+	constexpr auto n = mipp::nElReg<R>();
+
+	// the state 0 is the only valid final state (the alpha init. values are the same than the beta ones)
+	mipp::Reg<R> r_b[8];
+	for (auto j = 0; j < 8; j++)
+		r_b[j] = mipp::Reg<R>(&this->alpha[j][0]);
+
+	// compute the beta values [trellis backward traversal <-] + compute extrinsic values
+	for (auto i = this->K +2; i >= 0; i--)
+	{
+		const auto g0 = mipp::Reg<R>(&this->gamma[0][i * n]);
+		const auto g1 = mipp::Reg<R>(&this->gamma[1][i * n]);
+
+		// compute the extrinsic values (beta values are the ones of the stage i+1)
+		if (i < this->K)
+		{
+			mipp::Reg<R> r_a[8];
+			for (auto j = 0; j < 8; j++)
+				r_a[j] = mipp::Reg<R>(&this->alpha[j][i * n]);
+
+			auto max0 =              RSC_BCJR_inter_post<R>::add(r_a[0], r_b[0]) + g0;
+			max0      = MAX(max0,    RSC_BCJR_inter_post<R>::add(r_a[1], r_b[4]) + g0);
+			max0      = MAX(max0,    RSC_BCJR_inter_post<R>::add(r_a[2], r_b[5]) + g1);
+			max0      = MAX(max0,    RSC_BCJR_inter_post<R>::add(r_a[3], r_b[1]) + g1);
+			max0      = MAX(max0,    RSC_BCJR_inter_post<R>::add(r_a[4], r_b[2]) + g1);
+			max0      = MAX(max0,    RSC_BCJR_inter_post<R>::add(r_a[5], r_b[6]) + g1);
+			max0      = MAX(max0,    RSC_BCJR_inter_post<R>::add(r_a[6], r_b[7]) + g0);
+			max0      = MAX(max0,    RSC_BCJR_inter_post<R>::add(r_a[7], r_b[3]) + g0);
+
+			auto max1 =              RSC_BCJR_inter_post<R>::add(r_a[0], r_b[4]) - g0;
+			max1      = MAX(max1,    RSC_BCJR_inter_post<R>::add(r_a[1], r_b[0]) - g0);
+			max1      = MAX(max1,    RSC_BCJR_inter_post<R>::add(r_a[2], r_b[1]) - g1);
+			max1      = MAX(max1,    RSC_BCJR_inter_post<R>::add(r_a[3], r_b[5]) - g1);
+			max1      = MAX(max1,    RSC_BCJR_inter_post<R>::add(r_a[4], r_b[6]) - g1);
+			max1      = MAX(max1,    RSC_BCJR_inter_post<R>::add(r_a[5], r_b[2]) - g1);
+			max1      = MAX(max1,    RSC_BCJR_inter_post<R>::add(r_a[6], r_b[3]) - g0);
+			max1      = MAX(max1,    RSC_BCJR_inter_post<R>::add(r_a[7], r_b[7]) - g0);
+
+			const auto r_ext = RSC_BCJR_inter_post<R>::compute(max0, max1) - mipp::Reg<R>(&sys[i * n]);
+			r_ext.store(&ext[i * n]);
+		}
+
+		// compute the beta values of the stage i
+		if (i > 0)
+		{
+			mipp::Reg<R> r_b_cur[8];
+			r_b_cur[0] = MAX(r_b[0] + g0, r_b[4] - g0);
+			r_b_cur[1] = MAX(r_b[4] + g0, r_b[0] - g0);
+			r_b_cur[2] = MAX(r_b[5] + g1, r_b[1] - g1);
+			r_b_cur[3] = MAX(r_b[1] + g1, r_b[5] - g1);
+			r_b_cur[4] = MAX(r_b[2] + g1, r_b[6] - g1);
+			r_b_cur[5] = MAX(r_b[6] + g1, r_b[2] - g1);
+			r_b_cur[6] = MAX(r_b[7] + g0, r_b[3] - g0);
+			r_b_cur[7] = MAX(r_b[3] + g0, r_b[7] - g0);
+
+			RSC_BCJR_inter_normalize<R>::apply(r_b_cur, i);
+
+			for (auto j = 0; j < 8; j++)
+				r_b[j] = r_b_cur[j];
+		}
+	}
+}
+
+template <typename B, typename R, tools::proto_max_i<R> MAX>
+void Decoder_RSC_BCJR_inter_very_fast<B,R,MAX>
+::_decode_siso(const R *sys, const R *par, R *ext, const int frame_id)
+{
+	this->compute_gamma   (sys, par);
+	this->compute_alpha   (        );
+	this->compute_beta_ext(sys, ext);
+}
+}
+}
@@ -0,0 +1,56 @@
+#ifndef DECODER_RSC_BCJR_SEQ_RADIX4_HPP_
+#define DECODER_RSC_BCJR_SEQ_RADIX4_HPP_
+
+#include <vector>
+#include <mipp/mipp.h>
+
+#include "Tools/Math/max.h"
+
+#include "Decoder_RSC_BCJR_seq.hpp"
+
+namespace aff3ct
+{
+namespace module
+{
+/*!
+ * \class Decoder_RSC_BCJR_seq_radix4
+ *
+ * \brief Radix-4 BCJR: the forward and backward recursions merge two trellis stages per step, which halves the
+ *        length of the dependency chain of the recursions.
+ *
+ * The metrics of the intermediate nodes are computed with a radix-2 step from the previous node, off the critical
+ * path, such that the extrinsic values are the same as with the radix-2 decoder.
+ */
+template <typename B = int, typename R = float, typename RD = float,
+          tools::proto_max<R> MAX1 = tools::max, tools::proto_max<RD> MAX2 = tools::max>
+class Decoder_RSC_BCJR_seq_radix4 : public Decoder_RSC_BCJR_seq<B,R>
+{
+public:
+	Decoder_RSC_BCJR_seq_radix4(const int &K,
+	                            const std::vector<std::vector<int>> &trellis,
+	                            const bool buffered_encoding = true,
+	                            const int n_frames = 1,
+	                            const std::string name = "Decoder_RSC_BCJR_seq_radix4");
+	virtual ~Decoder_RSC_BCJR_seq_radix4();
+
+protected:
+	void _decode_siso(const R *sys, const R *par, R *ext, const int frame_id);
+
+	virtual void compute_gamma   (const R *sys, const R *par);
+	virtual void compute_alpha   (                          );
+	virtual void compute_beta_ext(const R *sys,       R *ext);
+
+	// one trellis stage (i -> i+1 for alpha, i+1 -> i for beta)
+	static inline void alpha_r2(const R a[8], R out[8], const R g0, const R g1);
+	static inline void beta_r2 (const R b[8], R out[8], const R g0, const R g1);
+
+	// two trellis stages (i -> i+2 for alpha, i+2 -> i for beta), ga = gamma[.][i], gb = gamma[.][i+1]
+	static inline void alpha_r4(const R a[8], R out[8], const R ga0, const R ga1, const R gb0, const R gb1);
+	static inline void beta_r4 (const R b[8], R out[8], const R ga0, const R ga1, const R gb0, const R gb1);
+};
+}
+}
+
+#include "Decoder_RSC_BCJR_seq_radix4.hxx"
+
+#endif /* DECODER_RSC_BCJR_SEQ_RADIX4_HPP_ */
@@ -0,0 +1,247 @@
+#include <sstream>
+#include <algorithm>
+
+#include "Tools/Exception/exception.hpp"
+
+#include "Decoder_RSC_BCJR_seq_radix4.hpp"
+
+namespace aff3ct
+{
+namespace module
+{
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+Decoder_RSC_BCJR_seq_radix4<B,R,RD,MAX1,MAX2>
+::Decoder_RSC_BCJR_seq_radix4(const int &K,
+                              const std::vector<std::vector<int>> &trellis,
+                              const bool buffered_encoding,
+                              const int n_frames,
+                              const std::string name)
+: Decoder_RSC_BCJR_seq<B,R>(K, trellis, buffered_encoding, n_frames, name)
+{
+	if (this->K % mipp::nElReg<R>() || mipp::nElReg<R>() % 2)
+	{
+		std::stringstream message;
+		message << "'K' has to be divisible by 'mipp::nElReg<R>()' and 'mipp::nElReg<R>()' has to be even ('K' = "
+		        << this->K << ", 'mipp::nElReg<R>()' = " << mipp::nElReg<R>() << ").";
+		throw tools::invalid_argument(__FILE__, __LINE__, __func__, message.str());
+	}
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+Decoder_RSC_BCJR_seq_radix4<B,R,RD,MAX1,MAX2>
+::~Decoder_RSC_BCJR_seq_radix4()
+{
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_radix4<B,R,RD,MAX1,MAX2>
+::alpha_r2(const R a[8], R out[8], const R g0, const R g1)
+{
+	out[0] = MAX1(a[0] + g0, a[1] - g0);
+	out[1] = MAX1(a[3] + g1, a[2] - g1);
+	out[2] = MAX1(a[4] + g1, a[5] - g1);
+	out[3] = MAX1(a[7] + g0, a[6] - g0);
+	out[4] = MAX1(a[1] + g0, a[0] - g0);
+	out[5] = MAX1(a[2] + g1, a[3] - g1);
+	out[6] = MAX1(a[5] + g1, a[4] - g1);
+	out[7] = MAX1(a[6] + g0, a[7] - g0);
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_radix4<B,R,RD,MAX1,MAX2>
+::beta_r2(const R b[8], R out[8], const R g0, const R g1)
+{
+	out[0] = MAX1(b[0] + g0, b[4] - g0);
+	out[1] = MAX1(b[4] + g0, b[0] - g0);
+	out[2] = MAX1(b[5] + g1, b[1] - g1);
+	out[3] = MAX1(b[1] + g1, b[5] - g1);
+	out[4] = MAX1(b[2] + g1, b[6] - g1);
+	out[5] = MAX1(b[6] + g1, b[2] - g1);
+	out[6] = MAX1(b[7] + g0, b[3] - g0);
+	out[7] = MAX1(b[3] + g0, b[7] - g0);
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_radix4<B,R,RD,MAX1,MAX2>
+::alpha_r4(const R a[8], R out[8], const R ga0, const R ga1, const R gb0, const R gb1)
+{
+	// merged branch metrics of the two stages
+	const R s00 = ga0 + gb0, d00 = ga0 - gb0;
+	const R s01 = ga0 + gb1, d01 = ga0 - gb1;
+	const R s10 = ga1 + gb0, d10 = ga1 - gb0;
+	const R s11 = ga1 + gb1, d11 = ga1 - gb1;
+
+	out[0] = MAX1(MAX1(a[0] + s00, a[1] - d00), MAX1(a[3] + d10, a[2] - s10));
+	out[1] = MAX1(MAX1(a[7] + s01, a[6] - d01), MAX1(a[4] + d11, a[5] - s11));
+	out[2] = MAX1(MAX1(a[1] + s01, a[0] - d01), MAX1(a[2] + d11, a[3] - s11));
+	out[3] = MAX1(MAX1(a[6] + s00, a[7] - d00), MAX1(a[5] + d10, a[4] - s10));
+	out[4] = MAX1(MAX1(a[3] + s10, a[2] - d10), MAX1(a[0] + d00, a[1] - s00));
+	out[5] = MAX1(MAX1(a[4] + s11, a[5] - d11), MAX1(a[7] + d01, a[6] - s01));
+	out[6] = MAX1(MAX1(a[2] + s11, a[3] - d11), MAX1(a[1] + d01, a[0] - s01));
+	out[7] = MAX1(MAX1(a[5] + s10, a[4] - d10), MAX1(a[6] + d00, a[7] - s00));
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_radix4<B,R,RD,MAX1,MAX2>
+::beta_r4(const R b[8], R out[8], const R ga0, const R ga1, const R gb0, const R gb1)
+{
+	// merged branch metrics of the two stages
+	const R s00 = ga0 + gb0, d00 = ga0 - gb0;
+	const R s01 = ga0 + gb1, d01 = ga0 - gb1;
+	const R s10 = ga1 + gb0, d10 = ga1 - gb0;
+	const R s11 = ga1 + gb1, d11 = ga1 - gb1;
+
+	out[0] = MAX1(MAX1(b[0] + s00, b[4] + d00), MAX1(b[2] - d01, b[6] - s01));
+	out[1] = MAX1(MAX1(b[2] + s01, b[6] + d01), MAX1(b[0] - d00, b[4] - s00));
+	out[2] = MAX1(MAX1(b[6] + s11, b[2] + d11), MAX1(b[4] - d10, b[0] - s10));
+	out[3] = MAX1(MAX1(b[4] + s10, b[0] + d10), MAX1(b[6] - d11, b[2] - s11));
+	out[4] = MAX1(MAX1(b[5] + s11, b[1] + d11), MAX1(b[7] - d10, b[3] - s10));
+	out[5] = MAX1(MAX1(b[7] + s10, b[3] + d10), MAX1(b[5] - d11, b[1] - s11));
+	out[6] = MAX1(MAX1(b[3] + s00, b[7] + d00), MAX1(b[1] - d01, b[5] - s01));
+	out[7] = MAX1(MAX1(b[1] + s01, b[5] + d01), MAX1(b[3] - d00, b[7] - s00));
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_radix4<B,R,RD,MAX1,MAX2>
+::compute_gamma(const R *sys, const R *par)
+{
+	// compute gamma values (auto-vectorized loop)
+	for (auto i = 0; i < this->K +3; i++)
+	{
+		this->gamma[0][i] = RSC_BCJR_seq_div_or_not<R>::apply(sys[i] + par[i]);
+		this->gamma[1][i] = RSC_BCJR_seq_div_or_not<R>::apply(sys[i] - par[i]);
+	}
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_radix4<B,R,RD,MAX1,MAX2>
+::compute_alpha()
+{
+	R alpha_cur[8];
+	for (auto k = 0; k < 8; k++)
+		alpha_cur[k] = this->alpha[k][0];
+
+	// compute alpha values [trellis forward traversal ->], two stages per step (only the alpha values of the
+	// information bits are required)
+	for (auto i = 0; i < this->K; i += 2)
+	{
+		R alpha_odd[8], alpha_nxt[8];
+		alpha_r4(alpha_cur, alpha_nxt, this->gamma[0][i], this->gamma[1][i], this->gamma[0][i+1], this->gamma[1][i+1]);
+		alpha_r2(alpha_cur, alpha_odd, this->gamma[0][i], this->gamma[1][i]);
+
+		RSC_BCJR_seq_normalize<R>::apply(alpha_odd, i +1);
+		RSC_BCJR_seq_normalize<R>::apply(alpha_nxt, i +2);
+
+		for (auto k = 0; k < 8; k++)
+		{
+			this->alpha[k][i +1] = alpha_odd[k];
+			this->alpha[k][i +2] = alpha_nxt[k];
+		}
+
+		std::copy(alpha_nxt, alpha_nxt +8, alpha_cur);
+	}
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_radix4<B,R,RD,MAX1,MAX2>
+::compute_beta_ext(const R *sys, R *ext)
+{
+	// compute the beta values of the tail bits [trellis backward traversal <-]
+	R beta_cur[8];
+	for (auto k = 0; k < 8; k++)
+		beta_cur[k] = this->alpha[k][0];
+	for (auto i = this->K +2; i >= this->K; i--)
+	{
+		R beta_prv[8];
+		std::copy(beta_cur, beta_cur +8, beta_prv);
+		beta_r2(beta_prv, beta_cur, this->gamma[0][i], this->gamma[1][i]);
+		RSC_BCJR_seq_normalize<R>::apply(beta_cur, i);
+	}
+
+	constexpr int block = mipp::nElReg<R>();
+	R beta_tmp[8][block];
+
+	// compute the beta values [trellis backward traversal <-] + compute extrinsic values
+	for (auto i = this->K -1; i >= 0; i -= block)
+	{
+		// beta_tmp[k][j] holds the metrics of the node i-j+1
+		for (auto k = 0; k < 8; k++)
+			beta_tmp[k][0] = beta_cur[k];
+
+		for (auto j = 2; j <= block; j += 2)
+		{
+			R b_prv[8], b_odd[8], b_nxt[8];
+			for (auto k = 0; k < 8; k++)
+				b_prv[k] = beta_tmp[k][j -2];
+
+			// the radix-4 step (node i-j+1) is on the critical path, the radix-2 step (node i-j+2) is not
+			const auto n = (i - j) +1;
+			beta_r4(b_prv, b_nxt, this->gamma[0][n], this->gamma[1][n], this->gamma[0][n+1], this->gamma[1][n+1]);
+			beta_r2(b_prv, b_odd, this->gamma[0][n+1], this->gamma[1][n+1]);
+
+			RSC_BCJR_seq_normalize<R>::apply(b_odd, j -1);
+			RSC_BCJR_seq_normalize<R>::apply(b_nxt, j   );
+
+			for (auto k = 0; k < 8; k++)
+				beta_tmp[k][j -1] = b_odd[k];
+
+			if (j < block)
+				for (auto k = 0; k < 8; k++)
+					beta_tmp[k][j] = b_nxt[k];
+			else
+				// metrics of the node i-block+1 (first node of the next block)
+				std::copy(b_nxt, b_nxt +8, beta_cur);
+		}
+
+		// (auto-vectorized loop)
+		RD tmp_post[2][8][block];
+		for (auto j = 0; j < block; j++)
+		{
+			const auto g0 = this->gamma[0][i-j];
+			const auto g1 = this->gamma[1][i-j];
+
+			tmp_post[0][0][j] = (RD)this->alpha[0][i-j] + (RD)beta_tmp[0][j] + (RD)g0;
+			tmp_post[0][1][j] = (RD)this->alpha[1][i-j] + (RD)beta_tmp[4][j] + (RD)g0;
+			tmp_post[0][2][j] = (RD)this->alpha[2][i-j] + (RD)beta_tmp[5][j] + (RD)g1;
+			tmp_post[0][3][j] = (RD)this->alpha[3][i-j] + (RD)beta_tmp[1][j] + (RD)g1;
+			tmp_post[0][4][j] = (RD)this->alpha[4][i-j] + (RD)beta_tmp[2][j] + (RD)g1;
+			tmp_post[0][5][j] = (RD)this->alpha[5][i-j] + (RD)beta_tmp[6][j] + (RD)g1;
+			tmp_post[0][6][j] = (RD)this->alpha[6][i-j] + (RD)beta_tmp[7][j] + (RD)g0;
+			tmp_post[0][7][j] = (RD)this->alpha[7][i-j] + (RD)beta_tmp[3][j] + (RD)g0;
+
+			tmp_post[1][0][j] = (RD)this->alpha[0][i-j] + (RD)beta_tmp[4][j] - (RD)g0;
+			tmp_post[1][1][j] = (RD)this->alpha[1][i-j] + (RD)beta_tmp[0][j] - (RD)g0;
+			tmp_post[1][2][j] = (RD)this->alpha[2][i-j] + (RD)beta_tmp[1][j] - (RD)g1;
+			tmp_post[1][3][j] = (RD)this->alpha[3][i-j] + (RD)beta_tmp[5][j] - (RD)g1;
+			tmp_post[1][4][j] = (RD)this->alpha[4][i-j] + (RD)beta_tmp[6][j] - (RD)g1;
+			tmp_post[1][5][j] = (RD)this->alpha[5][i-j] + (RD)beta_tmp[2][j] - (RD)g1;
+			tmp_post[1][6][j] = (RD)this->alpha[6][i-j] + (RD)beta_tmp[3][j] - (RD)g0;
+			tmp_post[1][7][j] = (RD)this->alpha[7][i-j] + (RD)beta_tmp[7][j] - (RD)g0;
+		}
+
+		// (auto-vectorized loop)
+		for (auto j = 0; j < block; j++)
+		{
+			auto max0 = tmp_post[0][0][j];
+			for (auto k = 1; k < 8; k++) // (auto-unrolled loop)
+				max0 = MAX2(max0, tmp_post[0][k][j]);
+
+			auto max1 = tmp_post[1][0][j];
+			for (auto k = 1; k < 8; k++) // (auto-unrolled loop)
+				max1 = MAX2(max1, tmp_post[1][k][j]);
+
+			ext[i-j] = RSC_BCJR_seq_post<R,RD>::compute(max0 - max1) - sys[i-j];
+		}
+	}
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_radix4<B,R,RD,MAX1,MAX2>
+::_decode_siso(const R *sys, const R *par, R *ext, const int frame_id)
+{
+	this->compute_gamma   (sys, par);
+	this->compute_alpha   (        );
+	this->compute_beta_ext(sys, ext);
+}
+}
+}
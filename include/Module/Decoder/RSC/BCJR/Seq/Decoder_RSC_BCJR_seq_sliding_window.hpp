@@ -0,0 +1,58 @@
+#ifndef DECODER_RSC_BCJR_SEQ_SLIDING_WINDOW_HPP_
+#define DECODER_RSC_BCJR_SEQ_SLIDING_WINDOW_HPP_
+
+#include <vector>
+#include <mipp/mipp.h>
+
+#include "Tools/Math/max.h"
+
+#include "Decoder_RSC_BCJR_seq.hpp"
+
+namespace aff3ct
+{
+namespace module
+{
+/*!
+ * \class Decoder_RSC_BCJR_seq_sliding_window
+ *
+ * \brief Sliding-window BCJR: the trellis is processed by windows of window_len stages, such that only the metrics
+ *        of one window are kept in memory (instead of the metrics of the whole frame).
+ *
+ * The forward metrics are continuous across windows. The backward recursion of each window starts from equiprobable
+ * metrics training_len stages after the end of the window (or from the terminated state at the end of the frame).
+ */
+template <typename B = int, typename R = float, typename RD = float,
+          tools::proto_max<R> MAX1 = tools::max, tools::proto_max<RD> MAX2 = tools::max>
+class Decoder_RSC_BCJR_seq_sliding_window : public Decoder_RSC_BCJR<B,R>
+{
+protected:
+	const int window_len;
+	const int training_len;
+
+	mipp::vector<R> alpha[8]; // node metric of the current window (left to right)
+	mipp::vector<R> gamma[2]; // edge metric of the current window and of its training stages
+
+public:
+	Decoder_RSC_BCJR_seq_sliding_window(const int &K,
+	                                    const std::vector<std::vector<int>> &trellis,
+	                                    const int window_len = 64,
+	                                    const int training_len = 32,
+	                                    const bool buffered_encoding = true,
+	                                    const int n_frames = 1,
+	                                    const std::string name = "Decoder_RSC_BCJR_seq_sliding_window");
+	virtual ~Decoder_RSC_BCJR_seq_sliding_window();
+
+protected:
+	void _decode_siso(const R *sys, const R *par, R *ext, const int frame_id);
+
+	virtual void compute_gamma   (const R *sys, const R *par, const int start, const int stop);
+	virtual void compute_alpha   (R alpha_cur[8], const int n_stages);
+	virtual void compute_beta_ext(const R *sys, R *ext, R beta_cur[8],
+	                              const int start, const int stop_win, const int stop);
+};
+}
+}
+
+#include "Decoder_RSC_BCJR_seq_sliding_window.hxx"
+
+#endif /* DECODER_RSC_BCJR_SEQ_SLIDING_WINDOW_HPP_ */
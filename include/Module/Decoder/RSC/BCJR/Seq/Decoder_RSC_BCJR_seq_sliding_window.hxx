@@ -0,0 +1,293 @@
+#include <limits>
+#include <sstream>
+#include <algorithm>
+
+#include "Tools/Exception/exception.hpp"
+
+#include "Decoder_RSC_BCJR_seq_sliding_window.hpp"
+
+namespace aff3ct
+{
+namespace module
+{
+template <typename R>
+struct RSC_BCJR_seq_sliding_window_init
+{
+	static R min_val()
+	{
+		return -std::numeric_limits<R>::max();
+	}
+};
+
+template <>
+struct RSC_BCJR_seq_sliding_window_init <short>
+{
+	static short min_val()
+	{
+		return -(1 << (sizeof(short) * 8 -2));
+	}
+};
+
+template <>
+struct RSC_BCJR_seq_sliding_window_init <signed char>
+{
+	static signed char min_val()
+	{
+		return -63;
+	}
+};
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+Decoder_RSC_BCJR_seq_sliding_window<B,R,RD,MAX1,MAX2>
+::Decoder_RSC_BCJR_seq_sliding_window(const int &K,
+                                      const std::vector<std::vector<int>> &trellis,
+                                      const int window_len,
+                                      const int training_len,
+                                      const bool buffered_encoding,
+                                      const int n_frames,
+                                      const std::string name)
+: Decoder_RSC_BCJR<B,R>(K, trellis, buffered_encoding, n_frames, 1, name),
+  window_len(std::min(window_len, K)), training_len(training_len)
+{
+	std::vector<std::vector<int>> req_trellis(10, std::vector<int>(8));
+	req_trellis[0] = { 0,  2,  4,  6,  0,  2,  4,  6};
+	req_trellis[1] = { 1, -1,  1, -1, -1,  1, -1,  1};
+	req_trellis[2] = { 0,  1,  1,  0,  0,  1,  1,  0};
+	req_trellis[3] = { 1,  3,  5,  7,  1,  3,  5,  7};
+	req_trellis[4] = {-1,  1, -1,  1,  1, -1,  1, -1};
+	req_trellis[5] = { 0,  1,  1,  0,  0,  1,  1,  0};
+	req_trellis[6] = { 0,  4,  5,  1,  2,  6,  7,  3};
+	req_trellis[7] = { 0,  0,  1,  1,  1,  1,  0,  0};
+	req_trellis[8] = { 4,  0,  1,  5,  6,  2,  3,  7};
+	req_trellis[9] = { 0,  0,  1,  1,  1,  1,  0,  0};
+
+	for (unsigned i = 0; i < req_trellis.size(); i++)
+		if (trellis[i] != req_trellis[i])
+			throw tools::invalid_argument(__FILE__, __LINE__, __func__, "Unsupported trellis.");
+
+	if (this->K % mipp::nElReg<R>())
+	{
+		std::stringstream message;
+		message << "'K' has to be divisible by 'mipp::nElReg<R>()' ('K' = " << this->K
+		        << ", 'mipp::nElReg<R>()' = " << mipp::nElReg<R>() << ").";
+		throw tools::invalid_argument(__FILE__, __LINE__, __func__, message.str());
+	}
+
+	if (window_len <= 0 || this->window_len % mipp::nElReg<R>())
+	{
+		std::stringstream message;
+		message << "'window_len' has to be a positive multiple of 'mipp::nElReg<R>()' ('window_len' = "
+		        << window_len << ", 'mipp::nElReg<R>()' = " << mipp::nElReg<R>() << ").";
+		throw tools::invalid_argument(__FILE__, __LINE__, __func__, message.str());
+	}
+
+	if (training_len < 0)
+	{
+		std::stringstream message;
+		message << "'training_len' has to be positive ('training_len' = " << training_len << ").";
+		throw tools::invalid_argument(__FILE__, __LINE__, __func__, message.str());
+	}
+
+	for (auto i = 0; i < 8; i++) alpha[i].resize(this->window_len);
+	for (auto i = 0; i < 2; i++) gamma[i].resize(this->window_len + training_len +3);
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+Decoder_RSC_BCJR_seq_sliding_window<B,R,RD,MAX1,MAX2>
+::~Decoder_RSC_BCJR_seq_sliding_window()
+{
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_sliding_window<B,R,RD,MAX1,MAX2>
+::compute_gamma(const R *sys, const R *par, const int start, const int stop)
+{
+	// compute gamma values of the stages [start; stop[ (auto-vectorized loop)
+	for (auto i = start; i < stop; i++)
+	{
+		this->gamma[0][i - start] = RSC_BCJR_seq_div_or_not<R>::apply(sys[i] + par[i]);
+		this->gamma[1][i - start] = RSC_BCJR_seq_div_or_not<R>::apply(sys[i] - par[i]);
+	}
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_sliding_window<B,R,RD,MAX1,MAX2>
+::compute_alpha(R alpha_cur[8], const int n_stages)
+{
+	// compute alpha values [trellis forward traversal ->], alpha_cur holds the metrics of the first node of the
+	// window and is updated with the metrics of the first node of the next window
+	for (auto i = 0; i < n_stages; i++)
+	{
+		for (auto k = 0; k < 8; k++)
+			this->alpha[k][i] = alpha_cur[k];
+
+		const auto g0 = this->gamma[0][i];
+		const auto g1 = this->gamma[1][i];
+
+		alpha_cur[0] = MAX1(this->alpha[0][i] + g0, this->alpha[1][i] - g0);
+		alpha_cur[1] = MAX1(this->alpha[3][i] + g1, this->alpha[2][i] - g1);
+		alpha_cur[2] = MAX1(this->alpha[4][i] + g1, this->alpha[5][i] - g1);
+		alpha_cur[3] = MAX1(this->alpha[7][i] + g0, this->alpha[6][i] - g0);
+		alpha_cur[4] = MAX1(this->alpha[1][i] + g0, this->alpha[0][i] - g0);
+		alpha_cur[5] = MAX1(this->alpha[2][i] + g1, this->alpha[3][i] - g1);
+		alpha_cur[6] = MAX1(this->alpha[5][i] + g1, this->alpha[4][i] - g1);
+		alpha_cur[7] = MAX1(this->alpha[6][i] + g0, this->alpha[7][i] - g0);
+
+		RSC_BCJR_seq_normalize<R>::apply(alpha_cur, i +1);
+	}
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_sliding_window<B,R,RD,MAX1,MAX2>
+::compute_beta_ext(const R *sys, R *ext, R beta_cur[8], const int start, const int stop_win, const int stop)
+{
+	// training: compute the beta values of the stages [stop_win; stop[ [trellis backward traversal <-], beta_cur
+	// holds the metrics of the node 'stop'
+	for (auto i = stop -1; i >= stop_win; i--)
+	{
+		const auto g0 = this->gamma[0][i - start];
+		const auto g1 = this->gamma[1][i - start];
+
+		R beta_prv[8];
+		std::copy(beta_cur, beta_cur +8, beta_prv);
+
+		beta_cur[0] = MAX1(beta_prv[0] + g0, beta_prv[4] - g0);
+		beta_cur[1] = MAX1(beta_prv[4] + g0, beta_prv[0] - g0);
+		beta_cur[2] = MAX1(beta_prv[5] + g1, beta_prv[1] - g1);
+		beta_cur[3] = MAX1(beta_prv[1] + g1, beta_prv[5] - g1);
+		beta_cur[4] = MAX1(beta_prv[2] + g1, beta_prv[6] - g1);
+		beta_cur[5] = MAX1(beta_prv[6] + g1, beta_prv[2] - g1);
+		beta_cur[6] = MAX1(beta_prv[7] + g0, beta_prv[3] - g0);
+		beta_cur[7] = MAX1(beta_prv[3] + g0, beta_prv[7] - g0);
+
+		RSC_BCJR_seq_normalize<R>::apply(beta_cur, i);
+	}
+
+	constexpr int block = mipp::nElReg<R>();
+	R beta_tmp[8][block];
+
+	// compute the beta values of the window [trellis backward traversal <-] + compute extrinsic values
+	for (auto i = stop_win -1; i >= start; i -= block)
+	{
+		// beta_tmp[k][j] holds the metrics of the node i-j+1
+		for (auto k = 0; k < 8; k++)
+			beta_tmp[k][0] = beta_cur[k];
+
+		for (auto j = 1; j < block; j++)
+		{
+			const auto g0 = this->gamma[0][(i-j)+1 - start];
+			const auto g1 = this->gamma[1][(i-j)+1 - start];
+
+			beta_tmp[0][j] = MAX1(beta_tmp[0][j-1] + g0, beta_tmp[4][j-1] - g0);
+			beta_tmp[1][j] = MAX1(beta_tmp[4][j-1] + g0, beta_tmp[0][j-1] - g0);
+			beta_tmp[2][j] = MAX1(beta_tmp[5][j-1] + g1, beta_tmp[1][j-1] - g1);
+			beta_tmp[3][j] = MAX1(beta_tmp[1][j-1] + g1, beta_tmp[5][j-1] - g1);
+			beta_tmp[4][j] = MAX1(beta_tmp[2][j-1] + g1, beta_tmp[6][j-1] - g1);
+			beta_tmp[5][j] = MAX1(beta_tmp[6][j-1] + g1, beta_tmp[2][j-1] - g1);
+			beta_tmp[6][j] = MAX1(beta_tmp[7][j-1] + g0, beta_tmp[3][j-1] - g0);
+			beta_tmp[7][j] = MAX1(beta_tmp[3][j-1] + g0, beta_tmp[7][j-1] - g0);
+			RSC_BCJR_seq_normalize<R>::apply(beta_tmp, j);
+		}
+
+		// (auto-vectorized loop)
+		RD tmp_post[2][8][block];
+		for (auto j = 0; j < block; j++)
+		{
+			const auto a  = (i-j) - start;
+			const auto g0 = this->gamma[0][a];
+			const auto g1 = this->gamma[1][a];
+
+			tmp_post[0][0][j] = (RD)this->alpha[0][a] + (RD)beta_tmp[0][j] + (RD)g0;
+			tmp_post[0][1][j] = (RD)this->alpha[1][a] + (RD)beta_tmp[4][j] + (RD)g0;
+			tmp_post[0][2][j] = (RD)this->alpha[2][a] + (RD)beta_tmp[5][j] + (RD)g1;
+			tmp_post[0][3][j] = (RD)this->alpha[3][a] + (RD)beta_tmp[1][j] + (RD)g1;
+			tmp_post[0][4][j] = (RD)this->alpha[4][a] + (RD)beta_tmp[2][j] + (RD)g1;
+			tmp_post[0][5][j] = (RD)this->alpha[5][a] + (RD)beta_tmp[6][j] + (RD)g1;
+			tmp_post[0][6][j] = (RD)this->alpha[6][a] + (RD)beta_tmp[7][j] + (RD)g0;
+			tmp_post[0][7][j] = (RD)this->alpha[7][a] + (RD)beta_tmp[3][j] + (RD)g0;
+
+			tmp_post[1][0][j] = (RD)this->alpha[0][a] + (RD)beta_tmp[4][j] - (RD)g0;
+			tmp_post[1][1][j] = (RD)this->alpha[1][a] + (RD)beta_tmp[0][j] - (RD)g0;
+			tmp_post[1][2][j] = (RD)this->alpha[2][a] + (RD)beta_tmp[1][j] - (RD)g1;
+			tmp_post[1][3][j] = (RD)this->alpha[3][a] + (RD)beta_tmp[5][j] - (RD)g1;
+			tmp_post[1][4][j] = (RD)this->alpha[4][a] + (RD)beta_tmp[6][j] - (RD)g1;
+			tmp_post[1][5][j] = (RD)this->alpha[5][a] + (RD)beta_tmp[2][j] - (RD)g1;
+			tmp_post[1][6][j] = (RD)this->alpha[6][a] + (RD)beta_tmp[3][j] - (RD)g0;
+			tmp_post[1][7][j] = (RD)this->alpha[7][a] + (RD)beta_tmp[7][j] - (RD)g0;
+		}
+
+		// (auto-vectorized loop)
+		for (auto j = 0; j < block; j++)
+		{
+			auto max0 = tmp_post[0][0][j];
+			for (auto k = 1; k < 8; k++) // (auto-unrolled loop)
+				max0 = MAX2(max0, tmp_post[0][k][j]);
+
+			auto max1 = tmp_post[1][0][j];
+			for (auto k = 1; k < 8; k++) // (auto-unrolled loop)
+				max1 = MAX2(max1, tmp_post[1][k][j]);
+
+			ext[i-j] = RSC_BCJR_seq_post<R,RD>::compute(max0 - max1) - sys[i-j];
+		}
+
+		// metrics of the first node of the next block
+		if (i - block >= start)
+		{
+			const auto g0 = this->gamma[0][(i - block +1) - start];
+			const auto g1 = this->gamma[1][(i - block +1) - start];
+
+			beta_cur[0] = MAX1(beta_tmp[0][block -1] + g0, beta_tmp[4][block -1] - g0);
+			beta_cur[1] = MAX1(beta_tmp[4][block -1] + g0, beta_tmp[0][block -1] - g0);
+			beta_cur[2] = MAX1(beta_tmp[5][block -1] + g1, beta_tmp[1][block -1] - g1);
+			beta_cur[3] = MAX1(beta_tmp[1][block -1] + g1, beta_tmp[5][block -1] - g1);
+			beta_cur[4] = MAX1(beta_tmp[2][block -1] + g1, beta_tmp[6][block -1] - g1);
+			beta_cur[5] = MAX1(beta_tmp[6][block -1] + g1, beta_tmp[2][block -1] - g1);
+			beta_cur[6] = MAX1(beta_tmp[7][block -1] + g0, beta_tmp[3][block -1] - g0);
+			beta_cur[7] = MAX1(beta_tmp[3][block -1] + g0, beta_tmp[7][block -1] - g0);
+			RSC_BCJR_seq_normalize<R>::apply(beta_cur, 0);
+		}
+	}
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_sliding_window<B,R,RD,MAX1,MAX2>
+::_decode_siso(const R *sys, const R *par, R *ext, const int frame_id)
+{
+	const auto n_stages = this->K +3; // including the tail bits
+	const auto min_val  = RSC_BCJR_seq_sliding_window_init<R>::min_val();
+
+	// the encoder starts in the state 0
+	R alpha_cur[8];
+	alpha_cur[0] = (R)0;
+	for (auto k = 1; k < 8; k++)
+		alpha_cur[k] = min_val;
+
+	for (auto start = 0; start < this->K; start += this->window_len)
+	{
+		const auto stop_win = std::min(start + this->window_len, this->K);
+		// the last windows are trained up to the terminated end of the trellis
+		const auto stop     = (stop_win + this->training_len >= this->K) ? n_stages
+		                                                                  : stop_win + this->training_len;
+
+		R beta_cur[8];
+		if (stop == n_stages)
+		{
+			// the encoder ends in the state 0
+			beta_cur[0] = (R)0;
+			for (auto k = 1; k < 8; k++)
+				beta_cur[k] = min_val;
+		}
+		else
+		{
+			// unknown state: equiprobable metrics
+			for (auto k = 0; k < 8; k++)
+				beta_cur[k] = (R)0;
+		}
+
+		this->compute_gamma   (sys, par, start, stop);
+		this->compute_alpha   (alpha_cur, stop_win - start);
+		this->compute_beta_ext(sys, ext, beta_cur, start, stop_win, stop);
+	}
+}
+}
+}
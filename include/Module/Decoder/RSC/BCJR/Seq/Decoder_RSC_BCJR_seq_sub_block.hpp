@@ -0,0 +1,85 @@
+#ifndef DECODER_RSC_BCJR_SEQ_SUB_BLOCK_HPP_
+#define DECODER_RSC_BCJR_SEQ_SUB_BLOCK_HPP_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <mipp/mipp.h>
+
+#include "Tools/Math/max.h"
+
+#include "Decoder_RSC_BCJR_seq.hpp"
+
+namespace aff3ct
+{
+namespace module
+{
+/*!
+ * \class Decoder_RSC_BCJR_seq_sub_block
+ *
+ * \brief Sub-block parallel BCJR: the trellis of a frame is split into n_sub_blocks sub-blocks whose forward and
+ *        backward recursions run concurrently, one thread per sub-block.
+ *
+ * The recursions of a sub-block start from the boundary metrics computed by the neighbouring sub-blocks during the
+ * previous decoding (next-iteration initialization). Hence, a separate instance is required for each constituent
+ * decoder of a turbo decoder, and reset() must be called before decoding a new frame.
+ */
+template <typename B = int, typename R = float, typename RD = float,
+          tools::proto_max<R> MAX1 = tools::max, tools::proto_max<RD> MAX2 = tools::max>
+class Decoder_RSC_BCJR_seq_sub_block : public Decoder_RSC_BCJR_seq<B,R>
+{
+protected:
+	const int n_sub_blocks;
+	std::vector<int> sb_start; // first stage of each sub-block (+ K)
+	R term[8];                 // metrics of the terminated trellis (state 0)
+
+	mipp::vector<R> alpha_bound[2]; // forward metrics at the first node of each sub-block (previous, next)
+	mipp::vector<R> beta_bound [2]; // backward metrics at the last node of each sub-block (previous, next)
+	int cur_bound;
+
+	// current job
+	const R *sys_ptr;
+	const R *par_ptr;
+	      R *ext_ptr;
+
+	std::vector<std::thread> workers;
+	std::mutex               mtx;
+	std::condition_variable  cv_start;
+	std::condition_variable  cv_done;
+	unsigned                 job_seq;
+	int                      n_pending;
+	bool                     stop;
+
+public:
+	Decoder_RSC_BCJR_seq_sub_block(const int &K,
+	                               const std::vector<std::vector<int>> &trellis,
+	                               const int n_sub_blocks = 2,
+	                               const bool buffered_encoding = true,
+	                               const int n_frames = 1,
+	                               const std::string name = "Decoder_RSC_BCJR_seq_sub_block");
+	virtual ~Decoder_RSC_BCJR_seq_sub_block();
+
+	/*!
+	 * \brief Resets the boundary metrics to equiprobable metrics (to be called before decoding a new frame).
+	 */
+	void reset();
+
+protected:
+	void _decode_siso(const R *sys, const R *par, R *ext, const int frame_id);
+
+	virtual void decode_sub_block(const int sb);
+
+	virtual void compute_gamma   (const R *sys, const R *par, const int start, const int stop);
+	virtual void compute_alpha   (const int sb                                              );
+	virtual void compute_beta_ext(const int sb, const R *sys, R *ext                        );
+
+private:
+	void worker(const int sb);
+};
+}
+}
+
+#include "Decoder_RSC_BCJR_seq_sub_block.hxx"
+
+#endif /* DECODER_RSC_BCJR_SEQ_SUB_BLOCK_HPP_ */
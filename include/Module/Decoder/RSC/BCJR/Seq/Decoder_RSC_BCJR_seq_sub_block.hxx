@@ -0,0 +1,338 @@
+#include <sstream>
+#include <algorithm>
+
+#include "Tools/Exception/exception.hpp"
+
+#include "Decoder_RSC_BCJR_seq_sub_block.hpp"
+
+namespace aff3ct
+{
+namespace module
+{
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+Decoder_RSC_BCJR_seq_sub_block<B,R,RD,MAX1,MAX2>
+::Decoder_RSC_BCJR_seq_sub_block(const int &K,
+                                 const std::vector<std::vector<int>> &trellis,
+                                 const int n_sub_blocks,
+                                 const bool buffered_encoding,
+                                 const int n_frames,
+                                 const std::string name)
+: Decoder_RSC_BCJR_seq<B,R>(K, trellis, buffered_encoding, n_frames, name),
+  n_sub_blocks(n_sub_blocks),
+  sb_start(n_sub_blocks +1),
+  cur_bound(0),
+  sys_ptr(nullptr),
+  par_ptr(nullptr),
+  ext_ptr(nullptr),
+  job_seq(0),
+  n_pending(0),
+  stop(false)
+{
+	constexpr int block = mipp::nElReg<R>();
+
+	if (this->K % block)
+	{
+		std::stringstream message;
+		message << "'K' has to be divisible by 'mipp::nElReg<R>()' ('K' = " << this->K
+		        << ", 'mipp::nElReg<R>()' = " << block << ").";
+		throw tools::invalid_argument(__FILE__, __LINE__, __func__, message.str());
+	}
+
+	if (n_sub_blocks <= 0 || n_sub_blocks > this->K / block)
+	{
+		std::stringstream message;
+		message << "'n_sub_blocks' has to be in [1;K/mipp::nElReg<R>()] ('n_sub_blocks' = " << n_sub_blocks
+		        << ", 'K' = " << this->K << ", 'mipp::nElReg<R>()' = " << block << ").";
+		throw tools::invalid_argument(__FILE__, __LINE__, __func__, message.str());
+	}
+
+	// sub-blocks of (almost) equal sizes, made of whole SIMD blocks
+	const auto n_blocks = this->K / block;
+	for (auto sb = 0; sb <= n_sub_blocks; sb++)
+		sb_start[sb] = ((sb * n_blocks) / n_sub_blocks) * block;
+
+	for (auto k = 0; k < 8; k++)
+		term[k] = this->alpha[k][0];
+
+	for (auto i = 0; i < 2; i++) alpha_bound[i].resize(n_sub_blocks * 8);
+	for (auto i = 0; i < 2; i++) beta_bound [i].resize(n_sub_blocks * 8);
+	this->reset();
+
+	// the calling thread decodes the first sub-block
+	for (auto sb = 1; sb < n_sub_blocks; sb++)
+		workers.push_back(std::thread(&Decoder_RSC_BCJR_seq_sub_block<B,R,RD,MAX1,MAX2>::worker, this, sb));
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+Decoder_RSC_BCJR_seq_sub_block<B,R,RD,MAX1,MAX2>
+::~Decoder_RSC_BCJR_seq_sub_block()
+{
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		stop = true;
+	}
+	cv_start.notify_all();
+	for (auto &t : workers)
+		t.join();
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_sub_block<B,R,RD,MAX1,MAX2>
+::reset()
+{
+	// equiprobable metrics
+	for (auto i = 0; i < 2; i++) std::fill(alpha_bound[i].begin(), alpha_bound[i].end(), (R)0);
+	for (auto i = 0; i < 2; i++) std::fill(beta_bound [i].begin(), beta_bound [i].end(), (R)0);
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_sub_block<B,R,RD,MAX1,MAX2>
+::worker(const int sb)
+{
+	unsigned seq = 0;
+
+	while (true)
+	{
+		std::unique_lock<std::mutex> lock(mtx);
+		cv_start.wait(lock, [&]{ return stop || job_seq != seq; });
+		if (stop)
+			return;
+		seq = job_seq;
+		lock.unlock();
+
+		this->decode_sub_block(sb);
+
+		lock.lock();
+		if (--n_pending == 0)
+			cv_done.notify_one();
+	}
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_sub_block<B,R,RD,MAX1,MAX2>
+::compute_gamma(const R *sys, const R *par, const int start, const int stop)
+{
+	// compute gamma values (auto-vectorized loop)
+	for (auto i = start; i < stop; i++)
+	{
+		this->gamma[0][i] = RSC_BCJR_seq_div_or_not<R>::apply(sys[i] + par[i]);
+		this->gamma[1][i] = RSC_BCJR_seq_div_or_not<R>::apply(sys[i] - par[i]);
+	}
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_sub_block<B,R,RD,MAX1,MAX2>
+::compute_alpha(const int sb)
+{
+	const auto start = sb_start[sb   ];
+	const auto stop  = sb_start[sb +1];
+	const auto prv   = &alpha_bound[    cur_bound][sb * 8];
+
+	// the first sub-block starts in the state 0, the others from the previous decoding
+	R alpha_cur[8];
+	for (auto k = 0; k < 8; k++)
+		alpha_cur[k] = (sb == 0) ? term[k] : prv[k];
+
+	// compute alpha values [trellis forward traversal ->]
+	for (auto i = start; i < stop; i++)
+	{
+		for (auto k = 0; k < 8; k++)
+			this->alpha[k][i] = alpha_cur[k];
+
+		const auto g0 = this->gamma[0][i];
+		const auto g1 = this->gamma[1][i];
+
+		alpha_cur[0] = MAX1(this->alpha[0][i] + g0, this->alpha[1][i] - g0);
+		alpha_cur[1] = MAX1(this->alpha[3][i] + g1, this->alpha[2][i] - g1);
+		alpha_cur[2] = MAX1(this->alpha[4][i] + g1, this->alpha[5][i] - g1);
+		alpha_cur[3] = MAX1(this->alpha[7][i] + g0, this->alpha[6][i] - g0);
+		alpha_cur[4] = MAX1(this->alpha[1][i] + g0, this->alpha[0][i] - g0);
+		alpha_cur[5] = MAX1(this->alpha[2][i] + g1, this->alpha[3][i] - g1);
+		alpha_cur[6] = MAX1(this->alpha[5][i] + g1, this->alpha[4][i] - g1);
+		alpha_cur[7] = MAX1(this->alpha[6][i] + g0, this->alpha[7][i] - g0);
+
+		RSC_BCJR_seq_normalize<R>::apply(alpha_cur, i +1);
+	}
+
+	// initialization of the next sub-block for the next decoding
+	if (sb < n_sub_blocks -1)
+	{
+		const auto nxt = &alpha_bound[1 - cur_bound][(sb +1) * 8];
+		for (auto k = 0; k < 8; k++)
+			nxt[k] = alpha_cur[k] - alpha_cur[0];
+	}
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_sub_block<B,R,RD,MAX1,MAX2>
+::compute_beta_ext(const int sb, const R *sys, R *ext)
+{
+	const auto start = sb_start[sb   ];
+	const auto stop  = sb_start[sb +1];
+
+	R beta_cur[8];
+	if (sb == n_sub_blocks -1)
+	{
+		// the last sub-block ends in the state 0, after the tail bits
+		std::copy(term, term +8, beta_cur);
+
+		for (auto i = this->K +2; i >= this->K; i--)
+		{
+			const auto g0 = this->gamma[0][i];
+			const auto g1 = this->gamma[1][i];
+
+			R beta_prv[8];
+			std::copy(beta_cur, beta_cur +8, beta_prv);
+
+			beta_cur[0] = MAX1(beta_prv[0] + g0, beta_prv[4] - g0);
+			beta_cur[1] = MAX1(beta_prv[4] + g0, beta_prv[0] - g0);
+			beta_cur[2] = MAX1(beta_prv[5] + g1, beta_prv[1] - g1);
+			beta_cur[3] = MAX1(beta_prv[1] + g1, beta_prv[5] - g1);
+			beta_cur[4] = MAX1(beta_prv[2] + g1, beta_prv[6] - g1);
+			beta_cur[5] = MAX1(beta_prv[6] + g1, beta_prv[2] - g1);
+			beta_cur[6] = MAX1(beta_prv[7] + g0, beta_prv[3] - g0);
+			beta_cur[7] = MAX1(beta_prv[3] + g0, beta_prv[7] - g0);
+
+			RSC_BCJR_seq_normalize<R>::apply(beta_cur, i);
+		}
+	}
+	else
+	{
+		// the other sub-blocks start from the previous decoding
+		const auto prv = &beta_bound[cur_bound][sb * 8];
+		std::copy(prv, prv +8, beta_cur);
+	}
+
+	constexpr int block = mipp::nElReg<R>();
+	R beta_tmp[8][block];
+
+	// compute the beta values [trellis backward traversal <-] + compute extrinsic values
+	for (auto i = stop -1; i >= start; i -= block)
+	{
+		// beta_tmp[k][j] holds the metrics of the node i-j+1
+		for (auto k = 0; k < 8; k++)
+			beta_tmp[k][0] = beta_cur[k];
+
+		for (auto j = 1; j < block; j++)
+		{
+			const auto g0 = this->gamma[0][(i-j)+1];
+			const auto g1 = this->gamma[1][(i-j)+1];
+
+			beta_tmp[0][j] = MAX1(beta_tmp[0][j-1] + g0, beta_tmp[4][j-1] - g0);
+			beta_tmp[1][j] = MAX1(beta_tmp[4][j-1] + g0, beta_tmp[0][j-1] - g0);
+			beta_tmp[2][j] = MAX1(beta_tmp[5][j-1] + g1, beta_tmp[1][j-1] - g1);
+			beta_tmp[3][j] = MAX1(beta_tmp[1][j-1] + g1, beta_tmp[5][j-1] - g1);
+			beta_tmp[4][j] = MAX1(beta_tmp[2][j-1] + g1, beta_tmp[6][j-1] - g1);
+			beta_tmp[5][j] = MAX1(beta_tmp[6][j-1] + g1, beta_tmp[2][j-1] - g1);
+			beta_tmp[6][j] = MAX1(beta_tmp[7][j-1] + g0, beta_tmp[3][j-1] - g0);
+			beta_tmp[7][j] = MAX1(beta_tmp[3][j-1] + g0, beta_tmp[7][j-1] - g0);
+			RSC_BCJR_seq_normalize<R>::apply(beta_tmp, j);
+		}
+
+		// (auto-vectorized loop)
+		RD tmp_post[2][8][block];
+		for (auto j = 0; j < block; j++)
+		{
+			const auto g0 = this->gamma[0][i-j];
+			const auto g1 = this->gamma[1][i-j];
+
+			tmp_post[0][0][j] = (RD)this->alpha[0][i-j] + (RD)beta_tmp[0][j] + (RD)g0;
+			tmp_post[0][1][j] = (RD)this->alpha[1][i-j] + (RD)beta_tmp[4][j] + (RD)g0;
+			tmp_post[0][2][j] = (RD)this->alpha[2][i-j] + (RD)beta_tmp[5][j] + (RD)g1;
+			tmp_post[0][3][j] = (RD)this->alpha[3][i-j] + (RD)beta_tmp[1][j] + (RD)g1;
+			tmp_post[0][4][j] = (RD)this->alpha[4][i-j] + (RD)beta_tmp[2][j] + (RD)g1;
+			tmp_post[0][5][j] = (RD)this->alpha[5][i-j] + (RD)beta_tmp[6][j] + (RD)g1;
+			tmp_post[0][6][j] = (RD)this->alpha[6][i-j] + (RD)beta_tmp[7][j] + (RD)g0;
+			tmp_post[0][7][j] = (RD)this->alpha[7][i-j] + (RD)beta_tmp[3][j] + (RD)g0;
+
+			tmp_post[1][0][j] = (RD)this->alpha[0][i-j] + (RD)beta_tmp[4][j] - (RD)g0;
+			tmp_post[1][1][j] = (RD)this->alpha[1][i-j] + (RD)beta_tmp[0][j] - (RD)g0;
+			tmp_post[1][2][j] = (RD)this->alpha[2][i-j] + (RD)beta_tmp[1][j] - (RD)g1;
+			tmp_post[1][3][j] = (RD)this->alpha[3][i-j] + (RD)beta_tmp[5][j] - (RD)g1;
+			tmp_post[1][4][j] = (RD)this->alpha[4][i-j] + (RD)beta_tmp[6][j] - (RD)g1;
+			tmp_post[1][5][j] = (RD)this->alpha[5][i-j] + (RD)beta_tmp[2][j] - (RD)g1;
+			tmp_post[1][6][j] = (RD)this->alpha[6][i-j] + (RD)beta_tmp[3][j] - (RD)g0;
+			tmp_post[1][7][j] = (RD)this->alpha[7][i-j] + (RD)beta_tmp[7][j] - (RD)g0;
+		}
+
+		// (auto-vectorized loop)
+		for (auto j = 0; j < block; j++)
+		{
+			auto max0 = tmp_post[0][0][j];
+			for (auto k = 1; k < 8; k++) // (auto-unrolled loop)
+				max0 = MAX2(max0, tmp_post[0][k][j]);
+
+			auto max1 = tmp_post[1][0][j];
+			for (auto k = 1; k < 8; k++) // (auto-unrolled loop)
+				max1 = MAX2(max1, tmp_post[1][k][j]);
+
+			ext[i-j] = RSC_BCJR_seq_post<R,RD>::compute(max0 - max1) - sys[i-j];
+		}
+
+		// metrics of the node i-block+1 (first node of the next block)
+		const auto g0 = this->gamma[0][(i - block) +1];
+		const auto g1 = this->gamma[1][(i - block) +1];
+
+		beta_cur[0] = MAX1(beta_tmp[0][block -1] + g0, beta_tmp[4][block -1] - g0);
+		beta_cur[1] = MAX1(beta_tmp[4][block -1] + g0, beta_tmp[0][block -1] - g0);
+		beta_cur[2] = MAX1(beta_tmp[5][block -1] + g1, beta_tmp[1][block -1] - g1);
+		beta_cur[3] = MAX1(beta_tmp[1][block -1] + g1, beta_tmp[5][block -1] - g1);
+		beta_cur[4] = MAX1(beta_tmp[2][block -1] + g1, beta_tmp[6][block -1] - g1);
+		beta_cur[5] = MAX1(beta_tmp[6][block -1] + g1, beta_tmp[2][block -1] - g1);
+		beta_cur[6] = MAX1(beta_tmp[7][block -1] + g0, beta_tmp[3][block -1] - g0);
+		beta_cur[7] = MAX1(beta_tmp[3][block -1] + g0, beta_tmp[7][block -1] - g0);
+		RSC_BCJR_seq_normalize<R>::apply(beta_cur, 0);
+	}
+
+	// initialization of the previous sub-block for the next decoding
+	if (sb > 0)
+	{
+		const auto nxt = &beta_bound[1 - cur_bound][(sb -1) * 8];
+		for (auto k = 0; k < 8; k++)
+			nxt[k] = beta_cur[k] - beta_cur[0];
+	}
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_sub_block<B,R,RD,MAX1,MAX2>
+::decode_sub_block(const int sb)
+{
+	// the last sub-block also handles the tail bits
+	const auto stop = (sb == n_sub_blocks -1) ? this->K +3 : sb_start[sb +1];
+
+	this->compute_gamma   (sys_ptr, par_ptr, sb_start[sb], stop);
+	this->compute_alpha   (sb                                  );
+	this->compute_beta_ext(sb, sys_ptr, ext_ptr                );
+}
+
+template <typename B, typename R, typename RD, tools::proto_max<R> MAX1, tools::proto_max<RD> MAX2>
+void Decoder_RSC_BCJR_seq_sub_block<B,R,RD,MAX1,MAX2>
+::_decode_siso(const R *sys, const R *par, R *ext, const int frame_id)
+{
+	sys_ptr = sys;
+	par_ptr = par;
+	ext_ptr = ext;
+
+	if (n_sub_blocks > 1)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			n_pending = n_sub_blocks -1;
+			job_seq++;
+		}
+		cv_start.notify_all();
+	}
+
+	this->decode_sub_block(0);
+
+	if (n_sub_blocks > 1)
+	{
+		std::unique_lock<std::mutex> lock(mtx);
+		cv_done.wait(lock, [&]{ return n_pending == 0; });
+	}
+
+	// the boundary metrics computed now are used by the next decoding
+	cur_bound = 1 - cur_bound;
+}
+}
+}
@@ -32,6 +32,7 @@ public:
 //protected:
 	void _load       (const R *Y_N,         const int frame_id);
 	void _decode_siho(const R *Y_N, B *V_K, const int frame_id);
+	void _decode     (                      const int frame_id); // iterative decoding of the loaded LLRs
 	void _store      (              B *V_K                    ) const;
 };
 }
@@ -9,6 +9,7 @@
 #define INTERLEAVER_HPP_
 
 #include <typeinfo>
+#include <memory>
 #include <string>
 #include <vector>
 #include <sstream>
@@ -37,8 +38,8 @@ class Interleaver_i : public Module
 protected:
 	const int size;
 	bool uniform;
-	std::vector<T> pi;     /*!< Lookup table for the interleaving process */
-	std::vector<T> pi_inv; /*!< Lookup table for the deinterleaving process */
+	std::shared_ptr<const std::vector<T>> pi;     /*!< Lookup table for the interleaving process */
+	std::shared_ptr<const std::vector<T>> pi_inv; /*!< Lookup table for the deinterleaving process */
 
 	bool init_called;
 
@@ -53,7 +54,9 @@ public:
 	Interleaver_i(const int size, const bool uniform = false, const int n_frames = 1,
 	              const std::string name = "Interleaver_i")
 	: Module(n_frames, name),
-	  size(size), uniform(uniform), pi(size * n_frames), pi_inv(size * n_frames), init_called(false)
+	  size(size), uniform(uniform),
+	  pi(std::make_shared<const std::vector<T>>()), pi_inv(std::make_shared<const std::vector<T>>()),
+	  init_called(false)
 	{
 		if (size <= 0)
 		{
@@ -84,11 +87,11 @@ public:
 	/*!
 	 * \brief Gets the lookup table required for the interleaving process.
 	 *
-	 * \return a vector of indirections.
+	 * \return a vector of indirections ('size' elements, or 'size' * 'n_frames' elements for uniform interleavers).
 	 */
 	const std::vector<T>& get_lut() const
 	{
-		return pi;
+		return *pi;
 	}
 
 	/*!
@@ -98,7 +101,7 @@ public:
 	 */
 	const std::vector<T>& get_lut_inv() const
 	{
-		return pi_inv;
+		return *pi_inv;
 	}
 
 	int get_size() const
@@ -157,7 +160,7 @@ public:
 	                       const int  n_frames = 1,
 	                       const bool frame_reordering = false) const
 	{
-		this->_interleave(natural_vec, interleaved_vec, pi, frame_reordering, n_frames, frame_id);
+		this->_interleave(natural_vec, interleaved_vec, *pi, frame_reordering, n_frames, frame_id);
 	}
 
 	/*!
@@ -211,7 +214,7 @@ public:
 	                         const int  n_frames = 1,
 	                         const bool frame_reordering = false) const
 	{
-		this->_interleave(interleaved_vec, natural_vec, pi_inv, frame_reordering, n_frames, frame_id);
+		this->_interleave(interleaved_vec, natural_vec, *pi_inv, frame_reordering, n_frames, frame_id);
 	}
 
 	/*!
@@ -229,21 +232,7 @@ public:
 		if (interleaver.uniform != this->uniform)
 			return false;
 
-		if (interleaver.pi.size() != this->pi.size())
-			return false;
-
-		if (interleaver.pi_inv.size() != this->pi_inv.size())
-			return false;
-
-		for (auto i = 0; i < (int)this->pi.size(); i++)
-			if (this->pi[i] != interleaver.pi[i])
-				return false;
-
-		for (auto i = 0; i < (int)this->pi_inv.size(); i++)
-			if (this->pi_inv[i] != interleaver.pi_inv[i])
-				return false;
-
-		return true;
+		return *interleaver.pi == *this->pi && *interleaver.pi_inv == *this->pi_inv;
 	}
 
 	bool operator!=(Interleaver_i<T> &interleaver) const
@@ -251,32 +240,27 @@ public:
 		return !(*this == interleaver);
 	}
 
-	void refresh()
+	/*!
+	 * \brief Regenerates the lookup tables. Non-uniform interleavers only store the lookup table of one frame since it
+	 *        is the same for all the frames.
+	 */
+	virtual void refresh()
 	{
-		this->gen_lut(this->pi.data(), 0);
-		for (auto i = 0; i < (int)this->get_size(); i++)
-			this->pi_inv[this->pi[i]] = i;
+		const auto n_luts = this->uniform ? this->n_frames : 1;
 
-		if (uniform)
+		std::vector<T> lut(this->size * n_luts), lut_inv(this->size * n_luts);
+		for (auto f = 0; f < n_luts; f++)
 		{
-			for (auto f = 1; f < this->n_frames; f++)
-			{
-				const auto off = f * this->size;
+			const auto off = f * this->size;
 
-				this->gen_lut(this->pi.data() + off, f);
+			this->gen_lut(lut.data() + off, f);
 
-				for (auto i = 0; i < this->get_size(); i++)
-					this->pi_inv[off + this->pi[off +i]] = i;
-			}
-		}
-		else
-		{
-			for (auto f = 1; f < this->n_frames; f++)
-			{
-				std::copy(pi    .data(), pi    .data() + size, pi    .data() + f * size);
-				std::copy(pi_inv.data(), pi_inv.data() + size, pi_inv.data() + f * size);
-			}
+			for (auto i = 0; i < this->get_size(); i++)
+				lut_inv[off + lut[off +i]] = i;
 		}
+
+		this->pi     = std::make_shared<const std::vector<T>>(std::move(lut    ));
+		this->pi_inv = std::make_shared<const std::vector<T>>(std::move(lut_inv));
 	}
 
 protected:
@@ -287,6 +271,46 @@ protected:
 	virtual void gen_lut(T *lut, const int frame_id) = 0;
 
 private:
+	template <typename D>
+	static inline void _gather(const D *in_vec, D *out_vec, const T *lut, const int size)
+	{
+		auto i = 0;
+		for (; i < size - 3; i += 4)
+		{
+			const auto d0 = in_vec[lut[i +0]];
+			const auto d1 = in_vec[lut[i +1]];
+			const auto d2 = in_vec[lut[i +2]];
+			const auto d3 = in_vec[lut[i +3]];
+			out_vec[i +0] = d0;
+			out_vec[i +1] = d1;
+			out_vec[i +2] = d2;
+			out_vec[i +3] = d3;
+		}
+		for (; i < size; i++)
+			out_vec[i] = in_vec[lut[i]];
+	}
+
+#ifdef __AVX2__
+	static inline void _gather(const float *in_vec, float *out_vec, const T *lut, const int size)
+	{
+		if (sizeof(T) != sizeof(int))
+		{
+			for (auto i = 0; i < size; i++)
+				out_vec[i] = in_vec[lut[i]];
+			return;
+		}
+
+		auto i = 0;
+		for (; i < size - 7; i += 8)
+		{
+			const auto idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lut + i));
+			_mm256_storeu_ps(out_vec + i, _mm256_i32gather_ps(in_vec, idx, 4));
+		}
+		for (; i < size; i++)
+			out_vec[i] = in_vec[lut[i]];
+	}
+#endif
+
 	template <typename D>
 	inline void _interleave(const D *in_vec, D *out_vec,
 	                        const std::vector<T> &lookup_table,
@@ -338,24 +362,20 @@ private:
 		{
 			if (!this->uniform)
 			{
-				// TODO: vectorize this code with the new AVX gather instruction
 				for (auto f = 0; f < n_frames; f++)
 				{
 					const auto off = f * this->get_size();
-					for (auto i = 0; i < this->get_size(); i++)
-						out_vec[off + i] = in_vec[off + lookup_table[i]];
+					_gather(in_vec + off, out_vec + off, lookup_table.data(), this->get_size());
 				}
 			}
 			else
 			{
 				auto cur_frame_id = frame_id % this->n_frames;
-				// TODO: vectorize this code with the new AVX gather instruction
 				for (auto f = 0; f < n_frames; f++)
 				{
 					const auto lut = lookup_table.data() + cur_frame_id * this->get_size();
 					const auto off = f * this->get_size();
-					for (auto i = 0; i < this->get_size(); i++)
-						out_vec[off + i] = in_vec[off + lut[i]];
+					_gather(in_vec + off, out_vec + off, lut, this->get_size());
 					cur_frame_id = (cur_frame_id +1) % this->n_frames;
 				}
 			}
@@ -0,0 +1,69 @@
+/*!
+ * \file
+ * \brief Quantizes floating-point data to fixed-point representation.
+ *
+ * \section LICENSE
+ * This file is under MIT license (https://opensource.org/licenses/MIT).
+ */
+#ifndef QUANTIZER_HPP_
+#define QUANTIZER_HPP_
+
+#include <string>
+#include <vector>
+
+#include "Module/Module.hpp"
+
+namespace aff3ct
+{
+namespace module
+{
+
+/*!
+ * \class Quantizer
+ *
+ * \brief Quantizes floating-point data to fixed-point representation.
+ *
+ * \tparam R: type of the reals (floating-point representation) in the Quantizer.
+ * \tparam Q: type of the quantified reals (fixed-point representation) in the Quantizer.
+ */
+template <typename R = float, typename Q = int>
+class Quantizer : public Module
+{
+protected:
+	const int N; /*!< Size of one frame (= number of bits in one frame) */
+
+public:
+	/*!
+	 * \brief Constructor.
+	 *
+	 * \param N:        size of one frame.
+	 * \param n_frames: number of frames to process in the Quantizer.
+	 */
+	Quantizer(const int N, const int n_frames = 1);
+
+	/*!
+	 * \brief Destructor.
+	 */
+	virtual ~Quantizer() = default;
+
+	int get_N() const;
+
+	/*!
+	 * \brief Quantizes the data if the fixed-point representation is used, else it only copies the data.
+	 *
+	 * \param Y_N1: a vector of floating-point data.
+	 * \param Y_N2: a vector of quantized data (fixed-point representation).
+	 */
+	template <class AR = std::allocator<R>, class AQ = std::allocator<Q>>
+	void process(const std::vector<R,AR>& Y_N1, std::vector<Q,AQ>& Y_N2, const int frame_id = -1);
+
+	virtual void process(const R *Y_N1, Q *Y_N2, const int frame_id = -1);
+
+protected:
+	virtual void _process(const R *Y_N1, Q *Y_N2, const int frame_id);
+};
+}
+}
+#include "Quantizer.hxx"
+
+#endif /* QUANTIZER_HPP_ */
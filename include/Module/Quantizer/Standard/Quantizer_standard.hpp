@@ -0,0 +1,35 @@
+#ifndef QUANTIZER_STANDARD_HPP_
+#define QUANTIZER_STANDARD_HPP_
+
+#include "../Quantizer.hpp"
+
+namespace aff3ct
+{
+namespace module
+{
+/*!
+ * \class Quantizer_standard
+ *
+ * \brief Rounds and saturates the reals on 'saturation_pos' bits, of which 'fixed_point_pos' are fractional bits.
+ */
+template <typename R = float, typename Q = int>
+class Quantizer_standard : public Quantizer<R,Q>
+{
+private:
+	const int fixed_point_pos;
+	const int saturation_pos;
+	const R   factor;
+	const Q   val_max;
+	const Q   val_min;
+
+public:
+	Quantizer_standard(const int N, const int fixed_point_pos, const int saturation_pos, const int n_frames = 1);
+	virtual ~Quantizer_standard() = default;
+
+protected:
+	void _process(const R *Y_N1, Q *Y_N2, const int frame_id);
+};
+}
+}
+
+#endif /* QUANTIZER_STANDARD_HPP_ */
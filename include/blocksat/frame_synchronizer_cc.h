@@ -42,7 +42,16 @@ namespace gr {
 			 * \param &preamble_syms Vector of complex preamble symbols
 			 * \param frame_len Frame length
 			 * \param M Constellation order
-			 * \param n_success_to_lock How many consecutive peaks until lock
+			 * \param n_success_to_lock Maximum number of frames confirming the
+			 *        frame start before lock, and number of consecutive
+			 *        frames without the preamble after which lock is lost
+			 *
+			 * With the fast lock (see set_fast_lock()), the confirmations
+			 * needed to lock scale with the PMF peak quality: a clean signal
+			 * locks after a single confirmation, and n_success_to_lock is
+			 * only reached at low SNR. A locked frame counts as without the
+			 * preamble when the peak-to-noise ratio at its start falls below
+			 * 2 (3 dB).
 			 * \param en_eq Enable gain scaling
 			 * \param en_phase_corr Enable phase correction per frame
 			 * \param en_freq_corr Enable fine frequency correction
@@ -53,6 +62,14 @@ namespace gr {
 			                 bool en_eq, bool en_phase_corr, bool en_freq_corr,
 			                 int debug_level);
 
+			/*!
+			 * \brief Enable the fast lock
+			 * \param enable Lock as soon as the PMF peaks are strong enough
+			 *        (the default). If false, lock always takes
+			 *        n_success_to_lock confirmations.
+			 */
+			virtual void set_fast_lock(bool enable) = 0;
+
 			/*!
 			 * \brief Get magnitude of PMF peak
 			 */
@@ -62,6 +79,15 @@ namespace gr {
 			 * \brief Get locked state
 			 */
 			virtual bool get_state() = 0;
+
+			/*!
+			 * \brief Get the time to lock of the last acquisition
+			 *
+			 * Symbols from the start of the acquisition (at startup or
+			 * after lock is lost) until the start of the first frame
+			 * locked to, or -1 if lock was never acquired.
+			 */
+			virtual int64_t get_time_to_lock() = 0;
 		};
 
 	} // namespace blocksat
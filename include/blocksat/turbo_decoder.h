@@ -24,6 +24,9 @@
 
 #include <blocksat/api.h>
 #include <gnuradio/sync_decimator.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
 
 namespace gr {
 	namespace blocksat {
@@ -45,8 +48,192 @@ namespace gr {
 			 * \param pct_en Enable the puncturer for 1/2 code rate
 			 * \param n_ite  Maximum number of decoding iterations
 			 * \param flip_llrs Flip the sign of the input LLRs
+			 * \param inter_frame Decode a batch of codewords at once, one
+			 *        per SIMD lane (partial batches are zero-padded)
+			 * \param n_threads Number of threads decoding codewords in
+			 *        parallel (the output order is preserved)
+			 * \param precision Bits per LLR within the decoder: 32 (float)
+			 *        or 16 (fixed-point, with input LLRs quantized to 6
+			 *        bits, 2 of which fractional). Fixed point requires
+			 *        SSE4.1. In intra-frame mode, K must be a multiple of the
+			 *        LLRs per SIMD register of some supported level: 4
+			 *        floats or 8 16-bit LLRs with SSE, twice as many with
+			 *        AVX2 and, for floats, 16 with AVX-512. The widest level
+			 *        dividing K is used.
+			 * \param crc CRC polynomial ("24-LTEA", "24-LTEB", "16-CCITT",
+			 *        "16-IBM", "8-DVB-S2" or "32-GZIP") carried by the last
+			 *        bits of each dataword. When set, decoding stops as soon
+			 *        as the CRC passes. Empty to always run n_ite iterations.
+			 * \param window_len Process the trellis in windows of window_len
+			 *        stages (sliding-window BCJR), such that the memory per
+			 *        codeword doesn't grow with K. Must be a multiple of the
+			 *        SIMD width. 0 processes the whole trellis at once. Not
+			 *        available in inter-frame mode.
+			 * \param training_len Stages used to estimate the backward
+			 *        metrics at the end of each window (sliding-window BCJR)
+			 * \param n_sub_blocks Split the trellis of each codeword into
+			 *        n_sub_blocks sub-blocks decoded concurrently on
+			 *        separate threads, which reduces the decoding latency.
+			 *        The sub-blocks are initialized with the boundary metrics
+			 *        of the previous iteration. 1 to disable. Not available
+			 *        with inter-frame mode or the sliding-window BCJR.
+			 * \param radix4 Use the radix-4 BCJR, which merges two trellis
+			 *        stages per recursion step. Not available with the other
+			 *        BCJR variants. Experimental: it currently decodes at
+			 *        only about 0.55-0.65x the throughput of the default
+			 *        radix-2 BCJR, so it is only meant for benchmarking.
+			 * \param pack_bits Output the decoded bits packed 8 per byte,
+			 *        MSB first (K / 8 bytes per codeword). Otherwise, each
+			 *        output byte holds a single bit. K must be a multiple of
+			 *        8 when packing.
+			 * \param max_op Max operator of the BCJR recursions: "max"
+			 *        (max-log-MAP), "max_star" (log-MAP, exact Jacobian
+			 *        logarithm) or "max_linear" (piecewise-linear
+			 *        approximation of the log-MAP correction). The last two
+			 *        require 32-bit precision.
+			 * \param ext_scale Factor applied to the extrinsic LLRs after
+			 *        each SISO decoding (e.g. 0.7 to compensate the
+			 *        overestimation of max-log-MAP). 1 to disable.
+			 * \param hd_stop Stop iterating on a codeword as soon as its
+			 *        hard decisions are unchanged over an iteration. Can be
+			 *        combined with the CRC, in which case either criterion
+			 *        stops the codeword. In inter-frame mode with either
+			 *        criterion, each SIMD lane stops independently and is
+			 *        refilled with the next pending codeword.
+			 *
+			 * The options of the block itself (statistics, second-chance
+			 * decoding and additional modes) are configured by the setters
+			 * below.
+			 */
+			static sptr make(int K, bool pct_en, int n_ite, bool flip_llrs,
+			                 bool inter_frame = false, int n_threads = 1,
+			                 int precision = 32,
+			                 const std::string &crc = "",
+			                 int window_len = 0, int training_len = 32,
+			                 int n_sub_blocks = 1, bool radix4 = false,
+			                 bool pack_bits = false,
+			                 const std::string &max_op = "max",
+			                 float ext_scale = 1.0,
+			                 bool hd_stop = false);
+
+			/*!
+			 * \brief Set the period of the messages with the decoding
+			 *        statistics published on the "stats" output port
+			 * \param period Period in seconds (1 by default), 0 to disable
+			 */
+			virtual void set_stats_period(float period) = 0;
+
+			/*!
+			 * \brief Enable the second-chance decoding
+			 *
+			 * Codewords that fail the CRC are decoded again in the
+			 * background, with up to n_ite iterations of the log-MAP BCJR.
+			 * The recovered codewords are published on the "recovered"
+			 * message port as PDUs: the decoded bytes, with the output
+			 * stream offset of the codeword ("offset") and the iterations
+			 * used ("n_ite") as metadata. Their regular output is left as
+			 * decoded online. Requires a CRC. Must be called before the
+			 * flowgraph starts.
+			 *
+			 * \param n_ite Iterations of the second-chance decoding, 0 to
+			 *        disable (default)
+			 * \param queue_len Maximum number of codewords waiting for
+			 *        second-chance decoding. The codewords failing while
+			 *        the queue is full are not decoded again.
+			 */
+			virtual void set_redecoding(int n_ite, int queue_len = 16) = 0;
+
+			/*!
+			 * \brief Set the additional modes, which can be selected at
+			 *        runtime without rebuilding the decoder
+			 *
+			 * The decoding modules of all modes are built upfront, with
+			 * the settings given to make. The mode applies from the first
+			 * codeword starting at or after a "turbo_mode" stream tag, or
+			 * after a message on the "mode" input port, both holding the
+			 * pair (K . pct_en). The first output byte of each codeword
+			 * decoded in a new mode carries the same tag. With additional
+			 * modes, the block is no longer fixed-rate and doesn't
+			 * propagate the input tags. Must be called before the
+			 * flowgraph starts.
+			 *
+			 * \param alt_K Dataword lengths of the additional modes (none
+			 *        by default)
+			 * \param alt_pct_en Puncturing (rate 1/2) of each additional
+			 *        mode, same length as alt_K
+			 */
+			virtual void set_alt_modes(const std::vector<int> &alt_K,
+			                           const std::vector<int> &alt_pct_en) = 0;
+
+			/*!
+			 * \brief Get the average number of iterations per codeword
+			 */
+			virtual float get_avg_iterations() = 0;
+
+			/*!
+			 * \brief Get the histogram of iterations per codeword
+			 *
+			 * Element i holds the number of codewords decoded in i
+			 * iterations, for i up to n_ite.
+			 */
+			virtual std::vector<int> get_iteration_hist() = 0;
+
+			/*!
+			 * \brief Reset all the decoding statistics
+			 */
+			virtual void reset_stats() = 0;
+
+			/*!
+			 * \brief Get the frame error rate
+			 *
+			 * Fraction of the codewords that failed the CRC or, without a
+			 * CRC, whose hard decisions didn't converge (hd_stop). Always
+			 * 0 without either criterion.
+			 */
+			virtual float get_fer() = 0;
+
+			/*!
+			 * \brief Get the number of codewords decoded
+			 */
+			virtual uint64_t get_n_frames() = 0;
+
+			/*!
+			 * \brief Get the number of codewords that failed decoding
+			 */
+			virtual uint64_t get_n_failures() = 0;
+
+			/*!
+			 * \brief Get the average decoding time per codeword in us
+			 *
+			 * The time from the load of a codeword into the decoder until
+			 * its output. Codewords decoded in the same SIMD batch share
+			 * the decoding time of the batch.
+			 */
+			virtual float get_avg_decode_time() = 0;
+
+			/*!
+			 * \brief Get the longest decoding time of a codeword in us
+			 */
+			virtual float get_max_decode_time() = 0;
+
+			/*!
+			 * \brief Get the number of codewords recovered by the
+			 *        second-chance decoding
+			 */
+			virtual uint64_t get_n_recovered() = 0;
+
+			/*!
+			 * \brief Get the SIMD level of the decoding kernels
+			 *
+			 * The kernels are built for several SIMD levels and the
+			 * highest one supported by the CPU, implementing the
+			 * configured precision and, in intra-frame mode, whose
+			 * registers divide K is selected at runtime: "avx512",
+			 * "avx2", "sse4.1" or "sse2" on x86, "generic" on other
+			 * architectures. The BLOCKSAT_SIMD environment variable can
+			 * force a lower level.
 			 */
-			static sptr make(int K, bool pct_en, int n_ite, bool flip_llrs);
+			virtual std::string get_simd_level() = 0;
 		};
 
 	} // namespace blocksat
@@ -572,22 +572,22 @@
 #ifdef __AVX512BW__
 	template <>
 	inline msk set<32>(const bool vals[32]) {
-		uint16_t v[32] = {vals[ 0] ? 0xFFFF : 0, vals[ 1] ? 0xFFFF : 0,
-		                  vals[ 2] ? 0xFFFF : 0, vals[ 3] ? 0xFFFF : 0,
-		                  vals[ 4] ? 0xFFFF : 0, vals[ 5] ? 0xFFFF : 0,
-		                  vals[ 6] ? 0xFFFF : 0, vals[ 7] ? 0xFFFF : 0,
-		                  vals[ 8] ? 0xFFFF : 0, vals[ 9] ? 0xFFFF : 0,
-		                  vals[10] ? 0xFFFF : 0, vals[11] ? 0xFFFF : 0,
-		                  vals[12] ? 0xFFFF : 0, vals[13] ? 0xFFFF : 0,
-		                  vals[14] ? 0xFFFF : 0, vals[15] ? 0xFFFF : 0,
-		                  vals[16] ? 0xFFFF : 0, vals[17] ? 0xFFFF : 0,
-		                  vals[18] ? 0xFFFF : 0, vals[19] ? 0xFFFF : 0,
-		                  vals[20] ? 0xFFFF : 0, vals[21] ? 0xFFFF : 0,
-		                  vals[22] ? 0xFFFF : 0, vals[23] ? 0xFFFF : 0,
-		                  vals[24] ? 0xFFFF : 0, vals[25] ? 0xFFFF : 0,
-		                  vals[26] ? 0xFFFF : 0, vals[27] ? 0xFFFF : 0,
-		                  vals[28] ? 0xFFFF : 0, vals[29] ? 0xFFFF : 0,
-		                  vals[30] ? 0xFFFF : 0, vals[31] ? 0xFFFF : 0}; 
+		uint16_t v[32] = {static_cast<uint16_t>(vals[ 0] ? 0xFFFF : 0), static_cast<uint16_t>(vals[ 1] ? 0xFFFF : 0),
+		                  static_cast<uint16_t>(vals[ 2] ? 0xFFFF : 0), static_cast<uint16_t>(vals[ 3] ? 0xFFFF : 0),
+		                  static_cast<uint16_t>(vals[ 4] ? 0xFFFF : 0), static_cast<uint16_t>(vals[ 5] ? 0xFFFF : 0),
+		                  static_cast<uint16_t>(vals[ 6] ? 0xFFFF : 0), static_cast<uint16_t>(vals[ 7] ? 0xFFFF : 0),
+		                  static_cast<uint16_t>(vals[ 8] ? 0xFFFF : 0), static_cast<uint16_t>(vals[ 9] ? 0xFFFF : 0),
+		                  static_cast<uint16_t>(vals[10] ? 0xFFFF : 0), static_cast<uint16_t>(vals[11] ? 0xFFFF : 0),
+		                  static_cast<uint16_t>(vals[12] ? 0xFFFF : 0), static_cast<uint16_t>(vals[13] ? 0xFFFF : 0),
+		                  static_cast<uint16_t>(vals[14] ? 0xFFFF : 0), static_cast<uint16_t>(vals[15] ? 0xFFFF : 0),
+		                  static_cast<uint16_t>(vals[16] ? 0xFFFF : 0), static_cast<uint16_t>(vals[17] ? 0xFFFF : 0),
+		                  static_cast<uint16_t>(vals[18] ? 0xFFFF : 0), static_cast<uint16_t>(vals[19] ? 0xFFFF : 0),
+		                  static_cast<uint16_t>(vals[20] ? 0xFFFF : 0), static_cast<uint16_t>(vals[21] ? 0xFFFF : 0),
+		                  static_cast<uint16_t>(vals[22] ? 0xFFFF : 0), static_cast<uint16_t>(vals[23] ? 0xFFFF : 0),
+		                  static_cast<uint16_t>(vals[24] ? 0xFFFF : 0), static_cast<uint16_t>(vals[25] ? 0xFFFF : 0),
+		                  static_cast<uint16_t>(vals[26] ? 0xFFFF : 0), static_cast<uint16_t>(vals[27] ? 0xFFFF : 0),
+		                  static_cast<uint16_t>(vals[28] ? 0xFFFF : 0), static_cast<uint16_t>(vals[29] ? 0xFFFF : 0),
+		                  static_cast<uint16_t>(vals[30] ? 0xFFFF : 0), static_cast<uint16_t>(vals[31] ? 0xFFFF : 0)}; 
 		auto r1 = set <int16_t>((int16_t*)v);
 		auto r2 = set1<int16_t>(0xFFFF);
 
@@ -597,22 +597,38 @@
 
 	template <>
 	inline msk set<64>(const bool vals[64]) {
-		uint8_t v[64] = {vals[ 0] ? 0xFF : 0, vals[ 1] ? 0xFF : 0, vals[ 2] ? 0xFF : 0, vals[ 3] ? 0xFF : 0,
-		                 vals[ 4] ? 0xFF : 0, vals[ 5] ? 0xFF : 0, vals[ 6] ? 0xFF : 0, vals[ 7] ? 0xFF : 0,
-		                 vals[ 8] ? 0xFF : 0, vals[ 9] ? 0xFF : 0, vals[10] ? 0xFF : 0, vals[11] ? 0xFF : 0,
-		                 vals[12] ? 0xFF : 0, vals[13] ? 0xFF : 0, vals[14] ? 0xFF : 0, vals[15] ? 0xFF : 0,
-		                 vals[16] ? 0xFF : 0, vals[17] ? 0xFF : 0, vals[18] ? 0xFF : 0, vals[19] ? 0xFF : 0,
-		                 vals[20] ? 0xFF : 0, vals[21] ? 0xFF : 0, vals[22] ? 0xFF : 0, vals[23] ? 0xFF : 0,
-		                 vals[24] ? 0xFF : 0, vals[25] ? 0xFF : 0, vals[26] ? 0xFF : 0, vals[27] ? 0xFF : 0,
-		                 vals[28] ? 0xFF : 0, vals[29] ? 0xFF : 0, vals[30] ? 0xFF : 0, vals[31] ? 0xFF : 0,
-		                 vals[32] ? 0xFF : 0, vals[33] ? 0xFF : 0, vals[34] ? 0xFF : 0, vals[35] ? 0xFF : 0,
-		                 vals[36] ? 0xFF : 0, vals[37] ? 0xFF : 0, vals[38] ? 0xFF : 0, vals[39] ? 0xFF : 0,
-		                 vals[40] ? 0xFF : 0, vals[41] ? 0xFF : 0, vals[42] ? 0xFF : 0, vals[43] ? 0xFF : 0,
-		                 vals[44] ? 0xFF : 0, vals[45] ? 0xFF : 0, vals[46] ? 0xFF : 0, vals[47] ? 0xFF : 0,
-		                 vals[48] ? 0xFF : 0, vals[49] ? 0xFF : 0, vals[50] ? 0xFF : 0, vals[51] ? 0xFF : 0,
-		                 vals[52] ? 0xFF : 0, vals[53] ? 0xFF : 0, vals[54] ? 0xFF : 0, vals[55] ? 0xFF : 0,
-		                 vals[56] ? 0xFF : 0, vals[57] ? 0xFF : 0, vals[58] ? 0xFF : 0, vals[59] ? 0xFF : 0,
-		                 vals[60] ? 0xFF : 0, vals[61] ? 0xFF : 0, vals[62] ? 0xFF : 0, vals[63] ? 0xFF : 0};
+		uint8_t v[64] = {static_cast<uint8_t>(vals[ 0] ? 0xFF : 0), static_cast<uint8_t>(vals[ 1] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[ 2] ? 0xFF : 0), static_cast<uint8_t>(vals[ 3] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[ 4] ? 0xFF : 0), static_cast<uint8_t>(vals[ 5] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[ 6] ? 0xFF : 0), static_cast<uint8_t>(vals[ 7] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[ 8] ? 0xFF : 0), static_cast<uint8_t>(vals[ 9] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[10] ? 0xFF : 0), static_cast<uint8_t>(vals[11] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[12] ? 0xFF : 0), static_cast<uint8_t>(vals[13] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[14] ? 0xFF : 0), static_cast<uint8_t>(vals[15] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[16] ? 0xFF : 0), static_cast<uint8_t>(vals[17] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[18] ? 0xFF : 0), static_cast<uint8_t>(vals[19] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[20] ? 0xFF : 0), static_cast<uint8_t>(vals[21] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[22] ? 0xFF : 0), static_cast<uint8_t>(vals[23] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[24] ? 0xFF : 0), static_cast<uint8_t>(vals[25] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[26] ? 0xFF : 0), static_cast<uint8_t>(vals[27] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[28] ? 0xFF : 0), static_cast<uint8_t>(vals[29] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[30] ? 0xFF : 0), static_cast<uint8_t>(vals[31] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[32] ? 0xFF : 0), static_cast<uint8_t>(vals[33] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[34] ? 0xFF : 0), static_cast<uint8_t>(vals[35] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[36] ? 0xFF : 0), static_cast<uint8_t>(vals[37] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[38] ? 0xFF : 0), static_cast<uint8_t>(vals[39] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[40] ? 0xFF : 0), static_cast<uint8_t>(vals[41] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[42] ? 0xFF : 0), static_cast<uint8_t>(vals[43] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[44] ? 0xFF : 0), static_cast<uint8_t>(vals[45] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[46] ? 0xFF : 0), static_cast<uint8_t>(vals[47] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[48] ? 0xFF : 0), static_cast<uint8_t>(vals[49] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[50] ? 0xFF : 0), static_cast<uint8_t>(vals[51] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[52] ? 0xFF : 0), static_cast<uint8_t>(vals[53] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[54] ? 0xFF : 0), static_cast<uint8_t>(vals[55] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[56] ? 0xFF : 0), static_cast<uint8_t>(vals[57] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[58] ? 0xFF : 0), static_cast<uint8_t>(vals[59] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[60] ? 0xFF : 0), static_cast<uint8_t>(vals[61] ? 0xFF : 0),
+		                 static_cast<uint8_t>(vals[62] ? 0xFF : 0), static_cast<uint8_t>(vals[63] ? 0xFF : 0)};
 		auto r1 = set <int8_t>((int8_t*)v);
 		auto r2 = set1<int8_t>(0xFF);
 
@@ -1896,18 +1912,19 @@
 	}
 
 	// ------------------------------------------------------------------------------------------------------------ abs
-	/*
+#if defined(__AVX512F__)
 	template <>
 	inline reg abs<double>(const reg v1) {
-		return _mm512_castpd_ps(_mm512_abs_pd(_mm512_castps_pd(v1)));
+		return _mm512_castsi512_ps(_mm512_and_epi64(_mm512_castps_si512(v1),
+		                                            _mm512_set1_epi64(0x7FFFFFFFFFFFFFFFLL)));
 	}
 
 	template <>
 	inline reg abs<float>(const reg v1) {
-		return _mm512_abs_ps(v1);
+		return _mm512_castsi512_ps(_mm512_and_epi32(_mm512_castps_si512(v1),
+		                                            _mm512_set1_epi32(0x7FFFFFFF)));
 	}
 
-#if defined(__AVX512F__)
 	template <>
 	inline reg abs<int64_t>(const reg v1) {
 		return _mm512_castsi512_ps(_mm512_abs_epi64(_mm512_castps_si512(v1)));
@@ -1930,7 +1947,6 @@
 		return _mm512_castsi512_ps(_mm512_abs_epi8(_mm512_castps_si512(v1)));
 	}
 #endif
-	*/
 
 	// ----------------------------------------------------------------------------------------------------------- sqrt
 #if defined(__AVX512F__)
@@ -1987,6 +2003,15 @@
 	inline reg log<float>(const reg v) {
 		return _mm512_log_ps(v);
 	}
+#else
+	// without SVML, evaluate each 256-bit half with avx_mathfun
+	template <>
+	inline reg log<float>(const reg v) {
+		const __m256 lo = log256_ps(_mm512_castps512_ps256(v));
+		const __m256 hi = log256_ps(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1)));
+		return _mm512_castpd_ps(_mm512_insertf64x4(_mm512_castps_pd(_mm512_castps256_ps512(lo)),
+		                                           _mm256_castps_pd(hi), 1));
+	}
 #endif
 #endif
 
@@ -2002,6 +2027,15 @@
 	inline reg exp<float>(const reg v) {
 		return _mm512_exp_ps(v);
 	}
+#else
+	// without SVML, evaluate each 256-bit half with avx_mathfun
+	template <>
+	inline reg exp<float>(const reg v) {
+		const __m256 lo = exp256_ps(_mm512_castps512_ps256(v));
+		const __m256 hi = exp256_ps(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1)));
+		return _mm512_castpd_ps(_mm512_insertf64x4(_mm512_castps_pd(_mm512_castps256_ps512(lo)),
+		                                           _mm256_castps_pd(hi), 1));
+	}
 #endif
 #endif
 
@@ -2242,7 +2276,7 @@
 #ifdef __AVX512BW__
 	template <>
 	inline reg cvt<int8_t,int16_t>(const reg_2 v) {
-		return _mm512_castsi512_ps(_mm512_cvtepi8_epi16(_mm_castps_si256(v)));
+		return _mm512_castsi512_ps(_mm512_cvtepi8_epi16(_mm256_castps_si256(v)));
 	}
 #endif
 
@@ -0,0 +1,145 @@
+#include <sstream>
+
+#include "Tools/Exception/exception.hpp"
+
+#include "Module/CRC/Polynomial/CRC_polynomial.hpp"
+
+using namespace aff3ct;
+using namespace aff3ct::module;
+
+template <typename B>
+const std::map<std::string, std::tuple<unsigned, int>> CRC_polynomial<B>::known_polynomials = {
+	{"32-GZIP"  , std::make_tuple(0x04C11DB7, 32)},
+	{"24-LTEA"  , std::make_tuple(0x00864CFB, 24)},
+	{"24-LTEB"  , std::make_tuple(0x00800063, 24)},
+	{"16-CCITT" , std::make_tuple(0x00001021, 16)},
+	{"16-IBM"   , std::make_tuple(0x00008005, 16)},
+	{"8-DVB-S2" , std::make_tuple(0x000000D5,  8)},
+};
+
+template <typename B>
+CRC_polynomial<B>
+::CRC_polynomial(const int K, std::string poly_key, const int size, const int n_frames)
+: CRC<B>(K, n_frames),
+  polynomial(CRC_polynomial<B>::get_value(poly_key)),
+  size      (size ? size : CRC_polynomial<B>::get_size(poly_key)),
+  mask      (this->size == 32 ? 0xFFFFFFFFu : (1u << this->size) -1),
+  lut       (256)
+{
+	if (this->size < 8 || this->size > 32)
+	{
+		std::stringstream message;
+		message << "'size' has to be in [8;32] ('size' = " << this->size << ").";
+		throw tools::invalid_argument(__FILE__, __LINE__, __func__, message.str());
+	}
+
+	// byte-wise table of the register update (the byte is aligned on the MSB of the register)
+	const unsigned top = 1u << (this->size -1);
+	for (unsigned b = 0; b < 256; b++)
+	{
+		unsigned reg = b << (this->size -8);
+		for (auto j = 0; j < 8; j++)
+			reg = (reg & top) ? (reg << 1) ^ polynomial : (reg << 1);
+		lut[b] = reg & mask;
+	}
+}
+
+template <typename B>
+int CRC_polynomial<B>
+::get_size()
+{
+	return size;
+}
+
+template <typename B>
+int CRC_polynomial<B>
+::get_size(std::string poly_key)
+{
+	if (known_polynomials.find(poly_key) != known_polynomials.end())
+		return std::get<1>(known_polynomials.at(poly_key));
+
+	std::stringstream message;
+	message << "'poly_key' is not a known CRC polynomial ('poly_key' = " << poly_key << ").";
+	throw tools::invalid_argument(__FILE__, __LINE__, __func__, message.str());
+}
+
+template <typename B>
+std::string CRC_polynomial<B>
+::get_name(std::string poly_key)
+{
+	CRC_polynomial<B>::get_size(poly_key);
+	return poly_key;
+}
+
+template <typename B>
+unsigned CRC_polynomial<B>
+::get_value(std::string poly_key)
+{
+	if (known_polynomials.find(poly_key) != known_polynomials.end())
+		return std::get<0>(known_polynomials.at(poly_key));
+
+	std::stringstream message;
+	message << "'poly_key' is not a known CRC polynomial ('poly_key' = " << poly_key << ").";
+	throw tools::invalid_argument(__FILE__, __LINE__, __func__, message.str());
+}
+
+template <typename B>
+unsigned CRC_polynomial<B>
+::compute(const B *U_K) const
+{
+	const auto K_bytes = this->K / 8;
+	unsigned reg = 0;
+
+	for (auto i = 0; i < K_bytes; i++)
+	{
+		unsigned byte = 0;
+		for (auto j = 0; j < 8; j++)
+			byte = (byte << 1) | (U_K[8 * i + j] ? 1u : 0u);
+		reg = ((reg << 8) ^ lut[((reg >> (size -8)) ^ byte) & 0xFF]) & mask;
+	}
+
+	// remaining bits (when K is not a multiple of 8)
+	const unsigned top = 1u << (size -1);
+	for (auto i = 8 * K_bytes; i < this->K; i++)
+	{
+		const unsigned fb = ((reg & top) ? 1u : 0u) ^ (U_K[i] ? 1u : 0u);
+		reg = ((reg << 1) ^ (fb ? polynomial : 0u)) & mask;
+	}
+
+	return reg;
+}
+
+template <typename B>
+void CRC_polynomial<B>
+::_build(const B *U_K1, B *U_K2, const int frame_id)
+{
+	std::copy(U_K1, U_K1 + this->K, U_K2);
+
+	const auto reg = this->compute(U_K1);
+	for (auto i = 0; i < size; i++)
+		U_K2[this->K + i] = (B)((reg >> (size -1 -i)) & 1);
+}
+
+template <typename B>
+bool CRC_polynomial<B>
+::_check(const B *V_K, const int frame_id)
+{
+	const auto reg = this->compute(V_K);
+	for (auto i = 0; i < size; i++)
+		if (((reg >> (size -1 -i)) & 1) != (V_K[this->K + i] ? 1u : 0u))
+			return false;
+
+	return true;
+}
+
+// ==================================================================================== explicit template instantiation
+#include "Tools/types.h"
+#ifdef MULTI_PREC
+template class aff3ct::module::CRC_polynomial<B_8>;
+template class aff3ct::module::CRC_polynomial<B_16>;
+template class aff3ct::module::CRC_polynomial<B_32>;
+template class aff3ct::module::CRC_polynomial<B_64>;
+#else
+template class aff3ct::module::CRC_polynomial<B>;
+#endif
+// ==================================================================================== explicit template instantiation
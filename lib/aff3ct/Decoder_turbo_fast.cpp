@@ -134,6 +134,22 @@ void Decoder_turbo_fast<B,R>
 	auto d_load = std::chrono::steady_clock::now() - t_load;
 
 	auto t_decod = std::chrono::steady_clock::now(); // -------------------------------------------------------- DECODE
+	this->_decode(frame_id);
+	auto d_decod = std::chrono::steady_clock::now() - t_decod;
+
+	auto t_store = std::chrono::steady_clock::now(); // --------------------------------------------------------- STORE
+	this->_store(V_K);
+	auto d_store = std::chrono::steady_clock::now() - t_store;
+
+	this->d_load_total  += d_load;
+	this->d_decod_total += d_decod;
+	this->d_store_total += d_store;
+}
+
+template <typename B, typename R>
+void Decoder_turbo_fast<B,R>
+::_decode(const int frame_id)
+{
 	const auto n_frames = this->get_simd_inter_frame_level();
 	const auto tail_n_2 = this->siso_n.tail_length() / 2;
 	const auto tail_i_2 = this->siso_i.tail_length() / 2;
@@ -208,15 +224,6 @@ void Decoder_turbo_fast<B,R>
 
 	for (auto cb : this->callbacks_end)
 		cb(ite -1);
-	auto d_decod = std::chrono::steady_clock::now() - t_decod;
-
-	auto t_store = std::chrono::steady_clock::now(); // --------------------------------------------------------- STORE
-	this->_store(V_K);
-	auto d_store = std::chrono::steady_clock::now() - t_store;
-
-	this->d_load_total  += d_load;
-	this->d_decod_total += d_decod;
-	this->d_store_total += d_store;
 }
 
 template <typename B, typename R>
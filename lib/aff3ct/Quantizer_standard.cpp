@@ -0,0 +1,87 @@
+#include <cmath>
+#include <sstream>
+#include <algorithm>
+
+#include "Tools/Exception/exception.hpp"
+
+#include "Module/Quantizer/Standard/Quantizer_standard.hpp"
+
+using namespace aff3ct;
+using namespace aff3ct::module;
+
+template <typename R, typename Q>
+Quantizer_standard<R,Q>
+::Quantizer_standard(const int N, const int fixed_point_pos, const int saturation_pos, const int n_frames)
+: Quantizer<R,Q>(N, n_frames),
+  fixed_point_pos(fixed_point_pos),
+  saturation_pos(saturation_pos),
+  factor((R)((1 << fixed_point_pos))),
+  val_max((Q)((1 << (saturation_pos -1)) -1)),
+  val_min(-val_max)
+{
+	if (fixed_point_pos < 0)
+	{
+		std::stringstream message;
+		message << "'fixed_point_pos' has to be positive ('fixed_point_pos' = " << fixed_point_pos << ").";
+		throw tools::invalid_argument(__FILE__, __LINE__, __func__, message.str());
+	}
+
+	if (fixed_point_pos >= saturation_pos)
+	{
+		std::stringstream message;
+		message << "'saturation_pos' has to be greater than 'fixed_point_pos' ('fixed_point_pos' = "
+		        << fixed_point_pos << ", 'saturation_pos' = " << saturation_pos << ").";
+		throw tools::invalid_argument(__FILE__, __LINE__, __func__, message.str());
+	}
+
+	if (saturation_pos > (int)sizeof(Q) * 8)
+	{
+		std::stringstream message;
+		message << "'saturation_pos' has to be equal or smaller than 'sizeof(Q)' * 8 ('saturation_pos' = "
+		        << saturation_pos << ", 'sizeof(Q)' = " << sizeof(Q) << ").";
+		throw tools::invalid_argument(__FILE__, __LINE__, __func__, message.str());
+	}
+}
+
+template <typename R, typename Q>
+void Quantizer_standard<R,Q>
+::_process(const R *Y_N1, Q *Y_N2, const int frame_id)
+{
+	// saturate in the floating-point domain first, such that the conversion cannot overflow
+	const auto vmax = (R)val_max;
+	const auto vmin = (R)val_min;
+	for (auto i = 0; i < this->N; i++)
+		Y_N2[i] = (Q)std::round(std::min(std::max(Y_N1[i] * factor, vmin), vmax));
+}
+
+namespace aff3ct
+{
+namespace module
+{
+template <>
+void Quantizer_standard<float,float>
+::_process(const float *Y_N1, float *Y_N2, const int frame_id)
+{
+	std::copy(Y_N1, Y_N1 + this->N, Y_N2);
+}
+
+template <>
+void Quantizer_standard<double,double>
+::_process(const double *Y_N1, double *Y_N2, const int frame_id)
+{
+	std::copy(Y_N1, Y_N1 + this->N, Y_N2);
+}
+}
+}
+
+// ==================================================================================== explicit template instantiation
+#include "Tools/types.h"
+#ifdef MULTI_PREC
+template class aff3ct::module::Quantizer_standard<R_8,Q_8>;
+template class aff3ct::module::Quantizer_standard<R_16,Q_16>;
+template class aff3ct::module::Quantizer_standard<R_32,Q_32>;
+template class aff3ct::module::Quantizer_standard<R_64,Q_64>;
+#else
+template class aff3ct::module::Quantizer_standard<R,Q>;
+#endif
+// ==================================================================================== explicit template instantiation
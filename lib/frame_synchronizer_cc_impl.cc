@@ -25,6 +25,8 @@
 #include <gnuradio/io_signature.h>
 #include <gnuradio/math.h>
 #include <volk/volk.h>
+#include <algorithm>
+#include <cfloat>
 #include <chrono>
 #include <ctime>
 #include <gnuradio/expj.h>
@@ -36,6 +38,23 @@
 #undef DEBUG_GAIN_EQ
 #undef DEBUG_FINE_FREQ_REC
 
+/* PMF peak candidates per frame, and samples around each peak within which
+ * no other candidate is taken */
+#define PMF_N_PEAKS    3
+#define PMF_PEAK_GUARD 1
+/* Frame start hypotheses tracked during acquisition, and consecutive frames
+ * without a matching PMF peak after which a hypothesis is dropped */
+#define FS_N_HYPOTHESES 4
+#define FS_MAX_MISSES   2
+/* Evidence for locking to a hypothesis, as the sum of the PSRs of its PMF
+ * peaks normalized by the preamble length. The normalized PSR of a peak is
+ * close to 1 on a clean signal and falls to about SNR / (1 + SNR) with
+ * noise, so a single confirmation suffices at high SNR. */
+#define FS_LOCK_EVIDENCE 1.5f
+/* Peak-to-noise ratio at the frame start below which a locked frame counts
+ * as a failure. Without the preamble, it is about 1. */
+#define FS_UNLOCK_PNR    2.0f
+
 #ifdef DEBUG
 #define debug_printf printf
 #else
@@ -83,9 +102,8 @@ namespace gr {
 			d_en_phase_corr(en_phase_corr),
 			d_debug_level(debug_level),
 			d_en_freq_corr(en_freq_corr),
+			d_fast_lock(true),
 			d_i_frame(0),
-			d_i_frame_start(0),
-			d_last_i_frame_start(0),
 			d_locked(false),
 			d_success_cnt(0),
 			d_fail_cnt(0),
@@ -94,8 +112,10 @@ namespace gr {
 			d_alpha(0.1),
 			d_beta(1.0 - 0.1),
 			d_avg_freq_offset(0.0),
-			d_first_iter(true),
-			d_i_frame_start_pre_realign(0)
+			d_pmf_pending(0),
+			d_acq_start(0),
+			d_time_to_lock(-1),
+			d_pnr(0)
 		{
 			/* Constants
 			 *
@@ -112,22 +132,43 @@ namespace gr {
 			/* Internal buffers */
 			d_align          = volk_get_alignment();
 			d_pmf_out_buffer = (gr_complex*) volk_malloc(d_frame_len * sizeof(gr_complex), d_align);
-			d_mag_pmf_buffer = (float*) volk_malloc(d_frame_len * sizeof(float), d_align);
-			d_i_max          = (uint32_t*) volk_malloc(sizeof(uint32_t), d_align);
 			d_pmf_tap_buffer = (gr_complex*) volk_malloc(d_preamble_len * sizeof(gr_complex), d_align);
 
 			/* PMF taps - the flipped and conjugated version of preamble */
 			d_preamble_syms.resize(d_preamble_len);
 			d_preamble_syms  = preamble_syms;
 			d_pmf_taps.resize(d_preamble_len);
+			d_preamble_energy = 0;
 			for(int i = 0; i < d_preamble_len; i++) {
+				d_preamble_energy += norm(preamble_syms[i]);
 				gr_complex tap = conj(preamble_syms[d_preamble_len - i - 1]);
 				/* Std vector with taps - used to initialize filter */
 				d_pmf_taps.push_back(tap);
 				/* Volk buffer with taps - used for direct dot product */
 				d_pmf_tap_buffer[i] = conj(preamble_syms[i]);
 			}
-			d_pmf = new gr::filter::kernel::fir_filter_with_buffer_ccc(d_pmf_taps);
+
+			/* The PMF runs on every frame until locked. For long preambles,
+			 * FFT fast convolution is cheaper than the direct form. */
+			int pmf_fft_len = OverlapSaveFilter::best_fft_len(d_pmf_taps.size(),
+			                                                  d_frame_len);
+			if (pmf_fft_len > 0) {
+				d_pmf     = NULL;
+				d_pmf_fft = new OverlapSaveFilter(d_pmf_taps, pmf_fft_len);
+			} else {
+				d_pmf     = new gr::filter::kernel::fir_filter_with_buffer_ccc(d_pmf_taps);
+				d_pmf_fft = NULL;
+			}
+			if (d_debug_level > 0) {
+				if (d_pmf_fft)
+					printf("%-21s PMF: overlap-save with FFT length %d\n",
+					       "[Frame Synchronizer ]", pmf_fft_len);
+				else
+					printf("%-21s PMF: direct-form FIR\n",
+					       "[Frame Synchronizer ]");
+			}
+			d_peak_search = new PeakSearch(PMF_N_PEAKS, PMF_PEAK_GUARD);
+			d_hyps.reserve(FS_N_HYPOTHESES);
 
 			/* Buffers used for fine freq. offset estimation */
 			d_L = d_preamble_len/2; // set weight window length to half preamble
@@ -160,8 +201,6 @@ namespace gr {
 		frame_synchronizer_cc_impl::~frame_synchronizer_cc_impl()
 		{
 			volk_free(d_pmf_out_buffer);
-			volk_free(d_mag_pmf_buffer);
-			volk_free(d_i_max);
 			volk_free(d_pmf_tap_buffer);
 			volk_free(d_preamble_mod_rm);
 			volk_free(d_preamble_corr);
@@ -172,6 +211,8 @@ namespace gr {
 			volk_free(d_w_angle_avg);
 			volk_free(d_fc_preamble_syms);
 			delete d_pmf;
+			delete d_pmf_fft;
+			delete d_peak_search;
 		}
 
 		void
@@ -184,6 +225,94 @@ namespace gr {
 			}
 		}
 
+		/* Preamble matched filter over one frame, into d_pmf_out_buffer */
+		void
+		frame_synchronizer_cc_impl::pmf(const gr_complex *in)
+		{
+			/* Skip the outputs carried over from the previous block */
+			const int n = d_frame_len - d_pmf_pending;
+
+			if (d_pmf_fft)
+				d_pmf_fft->filterN(d_pmf_out_buffer + d_pmf_pending,
+				                   in + d_pmf_pending, n);
+			else
+				d_pmf->filterN(d_pmf_out_buffer + d_pmf_pending,
+				               in + d_pmf_pending, n);
+			d_pmf_pending = 0;
+		}
+
+		int
+		frame_synchronizer_cc_impl::frame_start(int i_peak)
+		{
+			int i_frame_start = (i_peak - d_peak_delay) % d_frame_len;
+			/* The above is a remainder operation. We want a modulo
+			 * operation, which is accomplished by: */
+			if (i_frame_start < 0)
+				i_frame_start += d_frame_len;
+			return i_frame_start;
+		}
+
+		fs_hypothesis
+		frame_synchronizer_cc_impl::update_hypotheses(const std::vector<corr_peak> &peaks)
+		{
+			fs_hypothesis best = fs_hypothesis(); /* of the strongest peak */
+
+			for (unsigned j = 0; j < d_hyps.size(); j++)
+				d_hyps[j].misses++;
+
+			/* The strongest peak counts as a hit for the hypothesis of its
+			 * frame start, or starts a new one. The other candidates only
+			 * keep their hypothesis alive, as the true peak may be outranked
+			 * on a noisy frame. */
+			for (unsigned i = 0; i < peaks.size(); i++) {
+				const int i_start = frame_start(peaks[i].idx);
+				unsigned j = 0;
+				while (j < d_hyps.size() && d_hyps[j].i_start != i_start)
+					j++;
+
+				if (j < d_hyps.size()) {
+					d_hyps[j].misses = 0;
+					if (i == 0) {
+						d_hyps[j].hits++;
+						d_hyps[j].score += peaks[i].psr / d_preamble_len;
+						best = d_hyps[j];
+					}
+				} else if (i == 0) {
+					/* Replace the hypothesis of lowest score if full */
+					if (d_hyps.size() == FS_N_HYPOTHESES) {
+						unsigned j_min = 0;
+						for (j = 1; j < d_hyps.size(); j++)
+							if (d_hyps[j].score < d_hyps[j_min].score)
+								j_min = j;
+						d_hyps.erase(d_hyps.begin() + j_min);
+					}
+					d_hyps.push_back(fs_hypothesis{i_start, 0, 0,
+					                               peaks[i].psr / d_preamble_len});
+					best = d_hyps.back();
+				}
+			}
+
+			/* Drop the hypotheses that were not confirmed for too long */
+			for (unsigned j = 0; j < d_hyps.size();) {
+				if (d_hyps[j].misses > FS_MAX_MISSES)
+					d_hyps.erase(d_hyps.begin() + j);
+				else
+					j++;
+			}
+
+			if (d_debug_level > 1) {
+				for (unsigned j = 0; j < d_hyps.size(); j++) {
+					printf("%-21s Hypothesis %u: start %5d\thits %d\t",
+					       "[Frame Synchronizer ]", j, d_hyps[j].i_start,
+					       d_hyps[j].hits);
+					printf("misses %d\tevidence %6.2f\n", d_hyps[j].misses,
+					       d_hyps[j].score);
+				}
+			}
+
+			return best;
+		}
+
 		static void print_system_timestamp() {
 			std::chrono::time_point<std::chrono::system_clock> now;
 			now = std::chrono::system_clock::now();
@@ -287,57 +416,64 @@ namespace gr {
 			gr_complex *out = (gr_complex *) output_items[0];
 			gr_complex *pmf_out  = output_items.size() >= 2 ? (gr_complex *) output_items[1] : NULL;
 			int n_consumed = 0, n_produced = 0;
-			int n_frames = noutput_items / d_frame_len;
-			int i_offset;
 			int i_frame_start = 0;
 			gr_complex pmf_peak;
 			float pmf_peak_phase;
 			gr_complex phasor, phasor_0;
-			float freq_offset;
+			gr_complex rx_energy;
+			float freq_offset, peak_energy, noise_var;
 
-			/* Frame-by-frame processing */
-			for (int i_frame = 0; i_frame < n_frames; i_frame++) {
-				i_offset    = d_frame_len * i_frame;
-				n_consumed += d_frame_len;
+			/* Frame-by-frame processing
+			 *
+			 * While unlocked, the input is processed in consecutive blocks of
+			 * d_frame_len symbols. Once locked, each block starts at a frame
+			 * start, such that the preamble always lies entirely within the
+			 * block being processed.
+			 */
+			while (n_consumed + d_frame_len <= ninput_items[0] &&
+			       n_consumed + d_frame_len <= noutput_items &&
+			       n_produced + d_frame_len <= noutput_items) {
+				const gr_complex *in_frame = in + n_consumed;
+				int n_frame_in = d_frame_len; /* symbols consumed */
+				int n_frame_out = 0;          /* symbols produced */
+				bool pmf_done   = !d_locked;  /* PMF computed for the block */
 
 				if (!d_locked) {
 					/* cross-correlation - preamble matched filter */
-					d_pmf->filterN(d_pmf_out_buffer, in + i_offset, d_frame_len);
-					/* PMF output magnitude */
-					volk_32fc_magnitude_32f(d_mag_pmf_buffer, d_pmf_out_buffer,
-					                        d_frame_len);
-					/* FIXME: remove this magnitude computation and take the
-					 * maximum directly from the complex values using
-					 * "volk_32fc_index_max_32u". To do so, first investigate
-					 * why the result of the two functions differ by 1.
-					 */
-
-					/* PMF peak */
-					volk_32f_index_max_32u(d_i_max, d_mag_pmf_buffer, d_frame_len);
+					pmf(in_frame);
+					/* PMF peak candidates, taken straight from the squared
+					 * magnitude of the PMF output */
+					const std::vector<corr_peak> &peaks =
+						d_peak_search->search(d_pmf_out_buffer, d_frame_len);
+					const int i_max = peaks[0].idx;
 
 					/* Frame start index indicated by the current PMF peak */
-					i_frame_start  = (((int) (*d_i_max)) - d_peak_delay) % d_frame_len;
-					/* The above is a remainder operation. We want a modulo
-					 * operation, which is accomplished by: */
-					if (i_frame_start < 0)
-						i_frame_start += d_frame_len;
+					i_frame_start  = frame_start(i_max);
 
-					info_printf("index of max value = %u\n",  *d_i_max);
+					info_printf("index of max value = %d\n", i_max);
 					info_printf("index of frame start = %d\n", i_frame_start);
 
 					/* Complex PMF peak and magnitude of the PMF peak */
-					pmf_peak       = d_pmf_out_buffer[*d_i_max];
+					pmf_peak       = d_pmf_out_buffer[i_max];
 					d_mag_pmf_peak = abs(pmf_peak);
 
-					/* For locking, success is to have a peak in the same index
-					 * between consecutive frames. Reset the success count to
-					 * zero when not successful */
-					if (d_first_iter)
-						d_first_iter = false;
-					else if (i_frame_start == d_last_i_frame_start) {
-						d_success_cnt++;
-					} else
-						d_success_cnt = 0;
+					if (d_debug_level > 1) {
+						for (unsigned i = 0; i < peaks.size(); i++) {
+							printf("%-21s PMF peak candidate %u: idx %5d\t",
+							       "[Frame Synchronizer ]", i, peaks[i].idx);
+							printf("PSR: %6.2f dB\n",
+							       10 * log10(peaks[i].psr));
+						}
+					}
+
+					/* For locking, success is to have the strongest peak at
+					 * the same frame start index over several frames. Up to
+					 * FS_N_HYPOTHESES frame start indexes are tracked at once,
+					 * each tolerating FS_MAX_MISSES frames whose PMF peak is
+					 * elsewhere, so a single noisy frame does not restart the
+					 * acquisition. */
+					const fs_hypothesis hyp = update_hypotheses(peaks);
+					d_success_cnt = hyp.hits;
 
 					info_printf("success count = %d\n", d_success_cnt);
 
@@ -345,65 +481,38 @@ namespace gr {
 						printf("%-21s Matched peaks = %d / %d\t",
 						       "[Frame Synchronizer ]", d_success_cnt,
 						       d_n_success_to_lock);
-						printf("Previous peak idx: %5d\tCurrent peak idx: %5d\n",
-						       d_last_i_frame_start, i_frame_start);
+						printf("Evidence: %5.2f / %4.2f\tCurrent peak idx: %5d\n",
+						       hyp.score, FS_LOCK_EVIDENCE, i_frame_start);
 					}
 
-					d_last_i_frame_start = i_frame_start;
-
-					/* Just acquired frame timing lock */
-					if (d_success_cnt == d_n_success_to_lock) {
-						/* If we lock to an index that lies within a range of
-						 * "preamble_len - 1" indexes by the end of the frame
-						 * buffer, the math becomes complicated. This is because
-						 * in this case the preamble is partially on the current
-						 * buffer, and partially on the subsequent
-						 * buffer. Consequently, we would have to compute
-						 * cross-correlations in two steps and save state in
-						 * between.
-						 *
-						 * As a workaround, instead of proceeding with the frame
-						 * lock in this case, just return and try again
-						 * later. When returning, consume only the samples of
-						 * the previous frame, such that, next time, the
-						 * preamble of the new frame lies in the beginning of
-						 * the input buffer. This effectively realigns the data.
-						 *
-						 * Note also that this will affect the notion of frame
-						 * start index that is kept upstream at the coarse
-						 * frequency recovery block. This is because the
-						 * freq. recovery block assumes the entire frame is
-						 * always consumed. To solve this, we need to save an
-						 * offset corresponding to the number of symbols
-						 * consumed next for data realignment. Later on, we use
-						 * this offset on the initial report sent to the
-						 * freq. recovery block with the start index.
-						 */
-						if (i_frame_start > (d_frame_len - d_preamble_len)) {
-							n_consumed -= (d_frame_len - i_frame_start);
-							d_i_frame_start_pre_realign = i_frame_start;
-							consume_each(n_consumed);
-							return 0;
-						}
-
-						d_locked        = true;
-						d_i_frame_start = i_frame_start;
-						/* NOTE: variable "d_i_frame_start" holds the acquired
-						 * timing of the frame start. It is only updated here,
-						 * right when locking. In contrast, variable
-						 * "i_frame_start" holds the frame start according to
-						 * the processing of each individual frame. */
+					/* Just acquired frame timing lock
+					 *
+					 * With the fast lock, the number of confirmations scales
+					 * with the PSR of the peaks: lock as soon as the evidence
+					 * is sufficient, and at the latest after n_success_to_lock
+					 * confirmations. */
+					if (hyp.hits >= d_n_success_to_lock ||
+					    (d_fast_lock && hyp.hits > 0 &&
+					     hyp.score >= FS_LOCK_EVIDENCE)) {
+						/* Consume only up to the frame start, such that the
+						 * next block starts with the preamble. The symbols of
+						 * this block from the frame start on are processed
+						 * (and output) again as part of the next block, now
+						 * locked. Note the preamble of the frame starting at
+						 * i_frame_start may still extend past this block. */
+						d_locked   = true;
+						n_frame_in = i_frame_start;
+						d_hyps.clear();
+						d_time_to_lock = nitems_read(0) + n_consumed +
+						                 i_frame_start - d_acq_start;
 
 						printf("\n##########################################\n");
 						printf("-- Frame synchronization acquired\n");
 						print_system_timestamp();
+						printf("-- Time to lock: %lld symbols\n",
+						       (long long) d_time_to_lock);
 						printf("##########################################\n\n");
 
-						memcpy(out + n_produced,
-						       in + i_offset + i_frame_start,
-						       (d_frame_len - i_frame_start) * sizeof(gr_complex));
-						n_produced += (d_frame_len - i_frame_start);
-
 						/* Post the start index to the CFO recovery block
 						 *
 						 * Start with the actual index of the frame
@@ -418,11 +527,11 @@ namespace gr {
 						 * to be used by the CFO recovery block is better tuned
 						 * later (below) iteratively.
 						 *
-						 * Consider also that the realignment described above
-						 * may have occured.
+						 * The index is that of the frame start in the input
+						 * stream, modulo the frame length.
 						 */
-						d_start_idx_cfo = (i_frame_start +
-						                   d_i_frame_start_pre_realign) % d_frame_len;
+						d_start_idx_cfo = (nitems_read(0) + n_consumed +
+						                   i_frame_start) % d_frame_len;
 						message_port_pub(pmt::mp("start_index"),
 						                 pmt::from_long(d_start_idx_cfo));
 					}
@@ -439,14 +548,19 @@ namespace gr {
 					std::vector<tag_t> tags;
 					get_tags_in_window(tags,
 					                   0,
-					                   i_offset,
-					                   i_offset + d_frame_len - 1,
+					                   n_consumed,
+					                   n_consumed + d_frame_len,
 					                   pmt::mp("cfo"));
 					for (unsigned i = 0; i < tags.size(); i++) {
-						int tag_offset = tags[i].offset - nitems_read(0);
-
-						/* Is this offset as expected? */
-						int tag_offset_err = tag_offset - d_i_frame_start;
+						int tag_offset = tags[i].offset - nitems_read(0) -
+						                 n_consumed;
+
+						/* Is this offset as expected? The block starts at the
+						 * frame start, so a tag in its second half is taken as
+						 * early for the next frame. */
+						int tag_offset_err = tag_offset;
+						if (tag_offset_err > d_frame_len / 2)
+							tag_offset_err -= d_frame_len;
 						d_start_idx_cfo -= tag_offset_err;
 
 						/* Put start index within [0, frame_len) */
@@ -459,7 +573,7 @@ namespace gr {
 							printf("%-21s Got CFO tag at offset: %d\t",
 							       "[Frame Synchronizer ]", tag_offset);
 							printf("Expected: %d (error %d)\tSend new start: %d\n",
-							       d_i_frame_start, tag_offset_err,
+							       0, tag_offset_err,
 							       d_start_idx_cfo);
 						}
 
@@ -477,12 +591,12 @@ namespace gr {
 
 					/* Estimate new fine frequency offset and update average */
 					if (d_en_freq_corr) {
-						freq_offset       = est_freq_offset(in + i_offset + d_i_frame_start);
+						freq_offset       = est_freq_offset(in_frame);
 						d_avg_freq_offset = (d_alpha * freq_offset) + (d_beta * d_avg_freq_offset);
 
 						/* Send average downstream via tag */
 						add_item_tag(0,
-						             nitems_written(0) + d_i_frame_start,
+						             nitems_written(0) + n_produced,
 						             pmt::string_to_symbol("fs_fine_cfo"),
 						             pmt::from_float(d_avg_freq_offset));
 
@@ -507,17 +621,14 @@ namespace gr {
 					 * NOTE 2: this correction also helps with the estimation of
 					 * the PMF peak phase that is reported dowstream.
 					 *
-					 * NOTE 3: it is assumed here that, from index "in +
-					 * i_offset + d_i_frame_start", the entire preamble can be
-					 * found still within the current input buffer. This is
-					 * guaranteed by the fact that this block does not lock if
-					 * start index is greater than or equal to "(d_frame_len -
-					 * d_preamble_len)". See the note within the locking logic.
+					 * NOTE 3: while locked, the block being processed starts at
+					 * the frame start, so the entire preamble is always within
+					 * it. See the note within the locking logic.
 					 */
 					phasor   = gr_expj(-2 * M_PI * d_avg_freq_offset);
 					phasor_0 = gr_expj(0.0);
 					volk_32fc_s32fc_x2_rotator_32fc(d_fc_preamble_syms,
-					                                in + i_offset + d_i_frame_start,
+					                                in_frame,
 					                                phasor,
 					                                &phasor_0,
 					                                d_preamble_len);
@@ -538,10 +649,25 @@ namespace gr {
 					 * preamble symbols. */
 					d_mag_pmf_peak = abs(pmf_peak);
 
-					/* For unlocking, failure is when the cross-correlation
-					 * value observed at the frame starting index (that was
-					 * locked to) falls significantly below a threshold. */
-					if (d_mag_pmf_peak < (0.2 * float(d_preamble_len))) {
+					/* Peak-to-noise ratio: the energy of the preamble symbols
+					 * along the preamble (as captured by the PMF peak) over the
+					 * noise energy per symbol, estimated from the energy left
+					 * in the other dimensions. It does not depend on the signal
+					 * level and, with the preamble present, it is about
+					 * "preamble_len * SNR + 1". */
+					volk_32fc_x2_conjugate_dot_prod_32fc(&rx_energy,
+					                                     d_fc_preamble_syms,
+					                                     d_fc_preamble_syms,
+					                                     d_preamble_len);
+					peak_energy = norm(pmf_peak) / d_preamble_energy;
+					noise_var   = (rx_energy.real() - peak_energy) /
+					              std::max(d_preamble_len - 1, 1);
+					d_pnr       = peak_energy / std::max(noise_var, FLT_MIN);
+
+					/* For unlocking, failure is when the peak-to-noise ratio
+					 * observed at the frame starting index (that was locked
+					 * to) falls to the level expected without the preamble. */
+					if (d_pnr < FS_UNLOCK_PNR) {
 						d_fail_cnt++;
 						info_printf("failure count = %d\n", d_fail_cnt);
 
@@ -549,8 +675,10 @@ namespace gr {
 							printf("%-21s Unmatched peaks = %d / %d\t",
 							       "[Frame Synchronizer ]", d_fail_cnt,
 							       d_n_success_to_lock);
-							printf("Locked to idx: %5d\tCorr Magnitude: %f\n",
-							       d_i_frame_start, d_mag_pmf_peak);
+							printf("Locked to idx: %5d\tCorr Magnitude: %f\t",
+							       (int) ((nitems_read(0) + n_consumed) % d_frame_len),
+							       d_mag_pmf_peak);
+							printf("PNR: %6.2f dB\n", 10 * log10(d_pnr));
 						}
 					} else {
 						d_fail_cnt = 0;
@@ -561,24 +689,29 @@ namespace gr {
 						d_locked      = false;
 						d_success_cnt = 0;
 						d_fail_cnt    = 0;
+						d_acq_start   = nitems_read(0) + n_consumed +
+						                d_frame_len;
 
 						printf("\n##########################################\n");
 						printf("-- Frame synchronization lost\n");
 						print_system_timestamp();
 						printf("##########################################\n\n");
 
-						/* To preserve alignment on the output, output the
-						 * remaining part of the current frame before
-						 * unlocking. */
-						memcpy(out + n_produced, in + i_offset,
-						       d_i_frame_start * sizeof(gr_complex));
-						n_produced += d_i_frame_start;
+						/* The block started at the frame start, so the output
+						 * remains aligned to whole frames without it. */
+
+						/* While locked, the PMF only runs when its output is
+						 * connected. Otherwise, its history still holds the
+						 * symbols preceding the lock. Run it over this block,
+						 * such that the next acquisition continues from the
+						 * symbols that precede it. */
+						if (pmf_out == NULL)
+							pmf(in_frame);
 					} else {
-						/* Normal locked operation - output the entire block of
-						 * symbols being processed */
-						memcpy(out + n_produced, in + i_offset,
+						/* Normal locked operation - output the entire frame */
+						memcpy(out + n_produced, in_frame,
 						       d_frame_len * sizeof(gr_complex));
-						n_produced += d_frame_len;
+						n_frame_out = d_frame_len;
 					}
 				}
 
@@ -589,39 +722,50 @@ namespace gr {
 #endif
 
 				/* Tag phase correction */
-				if (d_locked == true && d_en_phase_corr == true)
+				if (n_frame_out > 0 && d_en_phase_corr == true)
 				{
 					/* Use the PMF peak to derive the phase error */
 					pmf_peak_phase = gr::fast_atan2f(pmf_peak);
 
 					add_item_tag(0,
-					             nitems_written(0) + d_i_frame_start,
+					             nitems_written(0) + n_produced,
 					             pmt::string_to_symbol("fs_phase"),
 					             pmt::from_float(pmf_peak_phase));
 				}
 
-				produce(0, n_produced);
+				if (n_frame_out > 0)
+					produce(0, n_frame_out);
 #ifdef DEBUG
 				for (int i = 0; i < d_frame_len; i++) {
 					debug_printf("%s: input symbol %4d\t (%4.4f, %4.4f)\n",
-					             __func__, i, in[i + i_offset].real(),
-					             in[i + i_offset].imag());
+					             __func__, i, in_frame[i].real(),
+					             in_frame[i].imag());
 					debug_printf("%s: mag pmf out %4d\t %4.2f\n",
-					             __func__, i, d_mag_pmf_buffer[i]);
+					             __func__, i, abs(d_pmf_out_buffer[i]));
 				}
 #endif
 				/* optional outputs */
 				if (pmf_out != NULL) {
 					/* PMF filtering that is not executed when locked */
-					if (d_locked) {
-						d_pmf->filterN(d_pmf_out_buffer, in + i_offset,
-						               d_frame_len);
+					if (!pmf_done)
+						pmf(in_frame);
+					memcpy(pmf_out + n_consumed, d_pmf_out_buffer,
+					       n_frame_in * sizeof(gr_complex));
+					if (n_frame_in > 0)
+						produce(1, n_frame_in);
+
+					/* The PMF output is kept 1:1 with the consumed input. When
+					 * lock is acquired, the outputs beyond the frame start are
+					 * carried over to the next block, which starts there. */
+					if (n_frame_in < d_frame_len) {
+						d_pmf_pending = d_frame_len - n_frame_in;
+						memmove(d_pmf_out_buffer, d_pmf_out_buffer + n_frame_in,
+						        d_pmf_pending * sizeof(gr_complex));
 					}
-					memcpy(pmf_out + i_offset, d_pmf_out_buffer,
-					       d_complex_frame_size_bytes);
-					produce(1, d_frame_len);
 				}
 
+				n_consumed += n_frame_in;
+				n_produced += n_frame_out;
 				d_i_frame++;
 			}
 
@@ -633,6 +777,11 @@ namespace gr {
 			return WORK_CALLED_PRODUCE;
 		}
 
+		void
+		frame_synchronizer_cc_impl::set_fast_lock(bool enable) {
+			d_fast_lock = enable;
+		}
+
 		float
 		frame_synchronizer_cc_impl::get_mag_pmf_peak() {
 			/* Normalize assuming unitary Es */
@@ -643,6 +792,11 @@ namespace gr {
 		frame_synchronizer_cc_impl::get_state() {
 			return d_locked;
 		}
+
+		int64_t
+		frame_synchronizer_cc_impl::get_time_to_lock() {
+			return d_time_to_lock;
+		}
 	} /* namespace blocksat */
 } /* namespace gr */
 
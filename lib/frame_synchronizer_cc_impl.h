@@ -23,10 +23,20 @@
 
 #include <blocksat/frame_synchronizer_cc.h>
 #include <gnuradio/filter/fir_filter_with_buffer.h>
+#include "overlap_save_filter.h"
+#include "peak_search.h"
 
 namespace gr {
 	namespace blocksat {
 
+		/* Frame start hypothesis of the acquisition */
+		struct fs_hypothesis {
+			int i_start; /* frame start index */
+			int hits;    /* later frames whose strongest PMF peak matched */
+			int misses;  /* consecutive frames without a matching PMF peak */
+			float score; /* lock evidence: accumulated normalized PSR */
+		};
+
 		class frame_synchronizer_cc_impl : public frame_synchronizer_cc
 		{
 		private:
@@ -40,17 +50,16 @@ namespace gr {
 			bool d_en_phase_corr;
 			bool d_en_freq_corr;
 			int d_debug_level;
+			bool d_fast_lock;
 			/* Other private variables */
 			gr::filter::kernel::fir_filter_with_buffer_ccc* d_pmf;
+			OverlapSaveFilter *d_pmf_fft; /* used instead of d_pmf if not NULL */
+			PeakSearch *d_peak_search;
 			int           d_i_frame;
 			int           d_preamble_len;
 			int           d_align;
 			gr_complex   *d_pmf_out_buffer;
-			float        *d_mag_pmf_buffer;
-			uint32_t     *d_i_max;
 			gr_complex   *d_pmf_tap_buffer;
-			int           d_i_frame_start;
-			int           d_last_i_frame_start;
 			int           d_peak_delay;
 			bool          d_locked;
 			unsigned int  d_success_cnt;
@@ -71,10 +80,17 @@ namespace gr {
 			float         d_alpha;
 			float         d_beta;
 			float         d_avg_freq_offset;
-			bool          d_first_iter;
-			int           d_i_frame_start_pre_realign;
+			int           d_pmf_pending; /* PMF outputs carried over the lock point */
+			std::vector<fs_hypothesis> d_hyps; /* by order of creation */
+			uint64_t      d_acq_start;    /* input index where acquisition began */
+			int64_t       d_time_to_lock; /* symbols, -1 until locked */
+			float         d_preamble_energy;
+			float         d_pnr; /* peak-to-noise ratio of the last locked frame */
 
 			float est_freq_offset(const gr_complex *in);
+			void pmf(const gr_complex *in);
+			int frame_start(int i_peak);
+			fs_hypothesis update_hypotheses(const std::vector<corr_peak> &peaks);
 
 		public:
 			frame_synchronizer_cc_impl(
@@ -90,9 +106,12 @@ namespace gr {
 			                 gr_vector_const_void_star &input_items,
 			                 gr_vector_void_star &output_items);
 
+			void set_fast_lock(bool enable);
+
 			// Public getters
 			float get_mag_pmf_peak();
 			bool get_state();
+			int64_t get_time_to_lock();
 		};
 	} // namespace blocksat
 } // namespace gr
@@ -0,0 +1,150 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Blockstream Corp.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "overlap_save_filter.h"
+#include <volk/volk.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+/* Relative cost of a complex multiplication within the FFTs, with respect
+ * to one within the (volk) dot products of the direct-form filter */
+#define FFT_MULT_COST 2.0
+/* Below this number of taps, the fixed overhead of the FFTs dominates */
+#define FFT_MIN_TAPS 32
+
+namespace gr {
+	namespace blocksat {
+
+		OverlapSaveFilter::OverlapSaveFilter(const std::vector<gr_complex> &taps,
+		                                     int fft_len)
+			: d_n_taps(taps.size()),
+			  d_fft_len(fft_len),
+			  d_block_len(fft_len - (int)taps.size() + 1)
+		{
+			if (taps.empty() || d_block_len < 1)
+				throw std::runtime_error("overlap_save_filter: FFT length too short for the taps");
+
+			d_fwd = new gr::fft::fft_complex(d_fft_len, true);
+			d_inv = new gr::fft::fft_complex(d_fft_len, false);
+
+			const int align = volk_get_alignment();
+			d_taps_fft = (gr_complex*) volk_malloc(d_fft_len * sizeof(gr_complex), align);
+			d_hist     = (gr_complex*) volk_malloc(std::max(d_n_taps - 1, 1) * sizeof(gr_complex), align);
+			std::fill(d_hist, d_hist + std::max(d_n_taps - 1, 1), gr_complex(0, 0));
+
+			/* Spectrum of the zero-padded taps. The inverse FFT is not
+			 * normalized, hence the 1/fft_len scaling. */
+			gr_complex *fin = d_fwd->get_inbuf();
+			std::fill(fin, fin + d_fft_len, gr_complex(0, 0));
+			memcpy(fin, taps.data(), d_n_taps * sizeof(gr_complex));
+			d_fwd->execute();
+			volk_32fc_s32fc_multiply_32fc(d_taps_fft, d_fwd->get_outbuf(),
+			                              gr_complex(1.0f / d_fft_len, 0.0f),
+			                              d_fft_len);
+		}
+
+		OverlapSaveFilter::~OverlapSaveFilter()
+		{
+			volk_free(d_taps_fft);
+			volk_free(d_hist);
+			delete d_fwd;
+			delete d_inv;
+		}
+
+		void
+		OverlapSaveFilter::filterN(gr_complex *out, const gr_complex *in,
+		                           unsigned long n)
+		{
+			const int n_hist = d_n_taps - 1;
+			gr_complex *fin  = d_fwd->get_inbuf();
+
+			for (unsigned long done = 0; done < n; done += d_block_len) {
+				const int len = (int)std::min((unsigned long)d_block_len,
+				                              n - done);
+
+				/* History followed by the new samples (zero-padded on the
+				 * last, partial block) */
+				memcpy(fin, d_hist, n_hist * sizeof(gr_complex));
+				memcpy(fin + n_hist, in + done, len * sizeof(gr_complex));
+				if (len < d_block_len)
+					std::fill(fin + n_hist + len, fin + d_fft_len,
+					          gr_complex(0, 0));
+
+				d_fwd->execute();
+				volk_32fc_x2_multiply_32fc(d_inv->get_inbuf(),
+				                           d_fwd->get_outbuf(), d_taps_fft,
+				                           d_fft_len);
+				d_inv->execute();
+
+				/* The first n_taps - 1 outputs are circular (discarded) */
+				memcpy(out + done, d_inv->get_outbuf() + n_hist,
+				       len * sizeof(gr_complex));
+
+				/* Keep the last n_taps - 1 input samples */
+				if (len >= n_hist) {
+					memcpy(d_hist, in + done + len - n_hist,
+					       n_hist * sizeof(gr_complex));
+				} else {
+					memmove(d_hist, d_hist + len,
+					        (n_hist - len) * sizeof(gr_complex));
+					memcpy(d_hist + n_hist - len, in + done,
+					       len * sizeof(gr_complex));
+				}
+			}
+		}
+
+		/*
+		 * Costs in complex multiplications per call: n_taps per output for
+		 * the direct form, against M/2 log2(M) per FFT of length M, two FFTs
+		 * and M products per block of M - n_taps + 1 outputs. The FFT
+		 * lengths are powers of two, up to the one fitting the whole call in
+		 * a single block.
+		 */
+		int
+		OverlapSaveFilter::best_fft_len(int n_taps, int n_out)
+		{
+			int best_len     = 0;
+			double best_cost = (double)n_taps * n_out;
+
+			if (n_taps < FFT_MIN_TAPS)
+				return 0;
+
+			int max_len = 1;
+			while (max_len < n_taps + n_out - 1)
+				max_len *= 2;
+
+			for (int M = 2; M <= max_len; M *= 2) {
+				const int block_len = M - n_taps + 1;
+				if (block_len < 1)
+					continue;
+
+				const int n_blocks = (n_out + block_len - 1) / block_len;
+				const double cost  = n_blocks * (FFT_MULT_COST * M * std::log2((double)M) + M);
+				if (cost < best_cost) {
+					best_cost = cost;
+					best_len  = M;
+				}
+			}
+			return best_len;
+		}
+	} /* namespace blocksat */
+} /* namespace gr */
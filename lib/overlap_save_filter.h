@@ -0,0 +1,75 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Blockstream Corp.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_BLOCKSAT_OVERLAP_SAVE_FILTER_H
+#define INCLUDED_BLOCKSAT_OVERLAP_SAVE_FILTER_H
+
+#include <gnuradio/gr_complex.h>
+#include <gnuradio/fft/fft.h>
+#include <vector>
+
+namespace gr {
+	namespace blocksat {
+
+		/*
+		 * Complex FIR filter applied by FFT fast convolution (overlap-save),
+		 * with the same streaming behavior as
+		 * gr::filter::kernel::fir_filter_with_buffer_ccc: the filter keeps
+		 * the last n_taps - 1 input samples from one call to the next, and
+		 * starts from a zeroed history. The spectrum of the taps and the FFT
+		 * plans are computed once, at construction.
+		 */
+		class OverlapSaveFilter
+		{
+		private:
+			int d_n_taps;
+			int d_fft_len;
+			int d_block_len; /* new input samples per FFT */
+			gr::fft::fft_complex *d_fwd;
+			gr::fft::fft_complex *d_inv;
+			gr_complex *d_taps_fft; /* spectrum of the taps, scaled by 1/fft_len */
+			gr_complex *d_hist;     /* last n_taps - 1 input samples */
+
+		public:
+			/*
+			 * \param taps Filter taps
+			 * \param fft_len FFT length (see best_fft_len)
+			 */
+			OverlapSaveFilter(const std::vector<gr_complex> &taps,
+			                  int fft_len);
+			~OverlapSaveFilter();
+
+			/*
+			 * \brief Filter n input samples into n output samples
+			 */
+			void filterN(gr_complex *out, const gr_complex *in,
+			             unsigned long n);
+
+			/*
+			 * \brief FFT length minimizing the cost of filtering n_out
+			 *        samples per call with n_taps, or 0 when the direct-form
+			 *        FIR filter is cheaper
+			 */
+			static int best_fft_len(int n_taps, int n_out);
+		};
+	} // namespace blocksat
+} // namespace gr
+
+#endif /* INCLUDED_BLOCKSAT_OVERLAP_SAVE_FILTER_H */
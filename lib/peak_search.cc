@@ -0,0 +1,143 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Blockstream Corp.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "peak_search.h"
+#include <algorithm>
+#include <cfloat>
+#include <stdexcept>
+
+/* Samples whose squared magnitude is computed (and vectorized) at once */
+#define PEAK_SEARCH_BLOCK 16
+
+namespace gr {
+	namespace blocksat {
+
+		PeakSearch::PeakSearch(int n_peaks, int guard)
+			: d_n_peaks(n_peaks),
+			  d_guard(guard)
+		{
+			if (n_peaks < 1)
+				throw std::runtime_error("PeakSearch: n_peaks must be >= 1");
+			if (guard < 0)
+				throw std::runtime_error("PeakSearch: guard must be >= 0");
+			d_peaks.reserve(n_peaks + 1);
+			d_recent.reserve(guard + 1);
+		}
+
+		/*
+		 * Samples are inserted by increasing index. Those skipped by the
+		 * search are weaker than all candidates, hence neither candidates
+		 * nor stronger than a candidate within its guard interval.
+		 */
+		void
+		PeakSearch::insert(int idx, float power)
+		{
+			/* Any sample within the guard interval that is at least as
+			 * strong suppresses this one, whether it is a candidate, was
+			 * suppressed itself or was evicted from the candidates */
+			std::vector<corr_peak>::iterator it = d_recent.begin();
+			while (it != d_recent.end() && it->idx < idx - d_guard)
+				it++;
+			d_recent.erase(d_recent.begin(), it);
+
+			bool suppressed = false;
+			for (it = d_recent.begin(); it != d_recent.end(); it++)
+				suppressed |= (it->power >= power);
+			d_recent.push_back(corr_peak{idx, power, 0});
+			if (suppressed)
+				return;
+
+			/* Candidates are more than d_guard samples apart and precede
+			 * idx, hence at most one lies within the guard interval, and it
+			 * is weaker */
+			for (it = d_peaks.begin(); it != d_peaks.end(); it++)
+				if (it->idx >= idx - d_guard)
+					break;
+
+			if (it != d_peaks.end()) {
+				d_peaks.erase(it);
+			} else if ((int) d_peaks.size() == d_n_peaks) {
+				if (power <= d_peaks.back().power)
+					return;
+				d_peaks.pop_back();
+			}
+
+			/* After the candidates of equal power, which came first */
+			it = d_peaks.begin();
+			while (it != d_peaks.end() && it->power >= power)
+				it++;
+			d_peaks.insert(it, corr_peak{idx, power, 0});
+		}
+
+		const std::vector<corr_peak> &
+		PeakSearch::search(const gr_complex *in, int n)
+		{
+			const float *x = (const float *) in;
+			float p[PEAK_SEARCH_BLOCK];
+			float sum[PEAK_SEARCH_BLOCK] = {}; /* per-lane partial sums */
+			float threshold = -1; /* power to beat to become a candidate */
+			int i = 0;
+
+			d_peaks.clear();
+			d_recent.clear();
+
+			for (; i + PEAK_SEARCH_BLOCK <= n; i += PEAK_SEARCH_BLOCK) {
+				const float *xb = x + 2*i;
+				int above = 0;
+
+				for (int j = 0; j < PEAK_SEARCH_BLOCK; j++) {
+					p[j]    = xb[2*j] * xb[2*j] + xb[2*j + 1] * xb[2*j + 1];
+					sum[j] += p[j];
+					above  |= (p[j] > threshold);
+				}
+
+				if (!above)
+					continue;
+
+				for (int j = 0; j < PEAK_SEARCH_BLOCK; j++) {
+					if (p[j] > threshold)
+						insert(i + j, p[j]);
+				}
+				if ((int) d_peaks.size() == d_n_peaks)
+					threshold = d_peaks.back().power;
+			}
+
+			/* Remaining samples */
+			for (; i < n; i++) {
+				p[0]    = x[2*i] * x[2*i] + x[2*i + 1] * x[2*i + 1];
+				sum[0] += p[0];
+				if (p[0] > threshold)
+					insert(i, p[0]);
+			}
+
+			float total = 0;
+			for (int j = 0; j < PEAK_SEARCH_BLOCK; j++)
+				total += sum[j];
+
+			/* Peak-to-sidelobe ratios */
+			for (unsigned k = 0; k < d_peaks.size(); k++) {
+				float sidelobe = (total - d_peaks[k].power) / std::max(n - 1, 1);
+				d_peaks[k].psr = d_peaks[k].power / std::max(sidelobe, FLT_MIN);
+			}
+
+			return d_peaks;
+		}
+	} // namespace blocksat
+} // namespace gr
@@ -0,0 +1,77 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Blockstream Corp.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_BLOCKSAT_PEAK_SEARCH_H
+#define INCLUDED_BLOCKSAT_PEAK_SEARCH_H
+
+#include <gnuradio/gr_complex.h>
+#include <vector>
+
+namespace gr {
+	namespace blocksat {
+
+		/* Correlation peak candidate */
+		struct corr_peak {
+			int idx;     /* index within the searched buffer */
+			float power; /* squared magnitude */
+			float psr;   /* peak-to-sidelobe ratio: power over the mean power
+			              * of all other samples of the buffer */
+		};
+
+		/*
+		 * Search of the strongest peaks of a complex correlator output, in a
+		 * single pass that computes the squared magnitudes block by block
+		 * (without an intermediate buffer) and only inspects the blocks that
+		 * hold a sample above the weakest candidate kept so far. A sample is
+		 * a candidate only if it is the strongest within guard samples on
+		 * each side (the earliest on a tie), such that the samples around a
+		 * peak don't count as other peaks.
+		 */
+		class PeakSearch
+		{
+		private:
+			int d_n_peaks;
+			int d_guard;
+			std::vector<corr_peak> d_peaks; /* by decreasing power */
+			std::vector<corr_peak> d_recent; /* samples inserted within the
+			                                  * last guard indexes */
+
+			void insert(int idx, float power);
+
+		public:
+			/*
+			 * \param n_peaks Maximum number of candidates
+			 * \param guard Samples on each side of a candidate within which
+			 *        no other candidate is kept
+			 */
+			PeakSearch(int n_peaks, int guard);
+
+			/*
+			 * \brief Search the peaks of n correlator output samples
+			 * \return Candidates by decreasing power. The first is the
+			 *         first occurrence of the maximum (as
+			 *         volk_32f_index_max_32u would return), unless n is 0.
+			 */
+			const std::vector<corr_peak> &search(const gr_complex *in, int n);
+		};
+	} // namespace blocksat
+} // namespace gr
+
+#endif /* INCLUDED_BLOCKSAT_PEAK_SEARCH_H */
@@ -26,11 +26,13 @@
  */
 
 #include "qa_blocksat.h"
+#include "qa_peak_search.h"
 
 CppUnit::TestSuite *
 qa_blocksat::suite()
 {
   CppUnit::TestSuite *s = new CppUnit::TestSuite("blocksat");
+  s->addTest(gr::blocksat::qa_peak_search::suite());
 
   return s;
 }
@@ -0,0 +1,132 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Blockstream Corp.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "qa_peak_search.h"
+#include "peak_search.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace gr {
+	namespace blocksat {
+
+		/* Correlator output whose squared magnitudes are the given powers */
+		static std::vector<gr_complex>
+		from_power(const std::vector<float> &power)
+		{
+			std::vector<gr_complex> x(power.size());
+			for (unsigned i = 0; i < power.size(); i++)
+				x[i] = gr_complex(std::sqrt(power[i]), 0);
+			return x;
+		}
+
+		/* The first candidate is the first occurrence of the maximum, also
+		 * when the length is not a multiple of the search block */
+		void
+		qa_peak_search::t1_argmax()
+		{
+			const int n = 1000;
+			std::vector<gr_complex> x(n);
+			std::vector<float> power(n);
+			srand(1);
+			for (int i = 0; i < n; i++) {
+				x[i] = gr_complex(rand() % 16, rand() % 16);
+				power[i] = std::norm(x[i]);
+			}
+
+			PeakSearch search(3, 1);
+			const std::vector<corr_peak> &peaks = search.search(&x[0], n);
+			const int i_max = std::max_element(power.begin(), power.end()) -
+			                  power.begin();
+			CPPUNIT_ASSERT_EQUAL(3, (int) peaks.size());
+			CPPUNIT_ASSERT_EQUAL(i_max, peaks[0].idx);
+			for (unsigned k = 1; k < peaks.size(); k++)
+				CPPUNIT_ASSERT(peaks[k].power <= peaks[k - 1].power);
+		}
+
+		/* The samples of a main lobe wider than the guard interval are not
+		 * taken as other candidates */
+		void
+		qa_peak_search::t2_shoulders()
+		{
+			std::vector<float> power(64, 0);
+			const float lobe[] = {2, 6, 9, 7, 5, 3}; /* peak at 20 */
+			for (int i = 0; i < 6; i++)
+				power[18 + i] = lobe[i];
+			power[45] = 4;
+			power[60] = 1;
+			const std::vector<gr_complex> x = from_power(power);
+
+			PeakSearch search(3, 1);
+			const std::vector<corr_peak> &peaks = search.search(&x[0], 64);
+			CPPUNIT_ASSERT_EQUAL(3, (int) peaks.size());
+			CPPUNIT_ASSERT_EQUAL(20, peaks[0].idx);
+			CPPUNIT_ASSERT_EQUAL(45, peaks[1].idx);
+			CPPUNIT_ASSERT_EQUAL(60, peaks[2].idx);
+		}
+
+		/* The strongest peaks are kept by decreasing power, the earliest
+		 * first on a tie, regardless of the candidates evicted before */
+		void
+		qa_peak_search::t3_top_n()
+		{
+			std::vector<float> power(200, 0);
+			const int idx[]   = {10, 40, 70, 100, 130, 160, 190};
+			const float pk[]  = { 3,  5,  2,   8,   5,   9,   1};
+			for (int k = 0; k < 7; k++) {
+				power[idx[k]]     = pk[k];
+				power[idx[k] + 1] = pk[k] - 0.5f; /* shoulder */
+				power[idx[k] + 3] = pk[k] - 1.0f; /* sidelobe past the guard */
+			}
+			const std::vector<gr_complex> x = from_power(power);
+
+			PeakSearch search(4, 2);
+			const std::vector<corr_peak> &peaks = search.search(&x[0], 200);
+			const int expected[] = {160, 100, 40, 130};
+			CPPUNIT_ASSERT_EQUAL(4, (int) peaks.size());
+			for (int k = 0; k < 4; k++)
+				CPPUNIT_ASSERT_EQUAL(expected[k], peaks[k].idx);
+		}
+
+		/* Peak-to-sidelobe ratio: power over the mean power of all other
+		 * samples */
+		void
+		qa_peak_search::t4_psr()
+		{
+			const int n = 77;
+			std::vector<float> power(n, 1);
+			power[30] = 100;
+			power[50] = 20;
+			const std::vector<gr_complex> x = from_power(power);
+
+			PeakSearch search(2, 3);
+			const std::vector<corr_peak> &peaks = search.search(&x[0], n);
+			const float total = (n - 2) + 100 + 20;
+			CPPUNIT_ASSERT_EQUAL(2, (int) peaks.size());
+			CPPUNIT_ASSERT_EQUAL(30, peaks[0].idx);
+			CPPUNIT_ASSERT_EQUAL(50, peaks[1].idx);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(100 / ((total - 100) / (n - 1)),
+			                             peaks[0].psr, 1e-3);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(20 / ((total - 20) / (n - 1)),
+			                             peaks[1].psr, 1e-3);
+		}
+
+	} /* namespace blocksat */
+} /* namespace gr */
@@ -0,0 +1,607 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Blockstream Corp.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "turbo_codec.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/* Without any level enabled by the build system, the kernels are built once
+ * for the compiler's default target */
+#if !defined(TURBO_CODEC_HAVE_AVX512) && !defined(TURBO_CODEC_HAVE_AVX2) && \
+    !defined(TURBO_CODEC_HAVE_SSE41) && !defined(TURBO_CODEC_HAVE_SSE2)
+#define TURBO_CODEC_HAVE_GENERIC
+#endif
+
+namespace gr {
+	namespace blocksat {
+
+		/* Constructor of the codec kernels built for a SIMD level (defined
+		 * in turbo_codec_impl.cc) */
+#define TURBO_CODEC_DECLARE_ISA(isa)                                     \
+		namespace isa {                                                \
+			TurboCodec *make_codec(int K, bool pct_en, int n_ite,      \
+			                       bool flip_llrs, bool inter_frame,   \
+			                       int precision,                      \
+			                       const std::string &crc,             \
+			                       int window_len, int training_len,   \
+			                       int n_sub_blocks, bool radix4,      \
+			                       bool pack_bits,                     \
+			                       const std::string &max_op,          \
+			                       float ext_scale, bool hd_stop);     \
+			int simd_lanes(int precision);                             \
+		}
+
+#ifdef TURBO_CODEC_HAVE_AVX512
+		TURBO_CODEC_DECLARE_ISA(avx512)
+#endif
+#ifdef TURBO_CODEC_HAVE_AVX2
+		TURBO_CODEC_DECLARE_ISA(avx2)
+#endif
+#ifdef TURBO_CODEC_HAVE_SSE41
+		TURBO_CODEC_DECLARE_ISA(sse41)
+#endif
+#ifdef TURBO_CODEC_HAVE_SSE2
+		TURBO_CODEC_DECLARE_ISA(sse2)
+#endif
+#ifdef TURBO_CODEC_HAVE_GENERIC
+		TURBO_CODEC_DECLARE_ISA(generic)
+#endif
+
+		typedef TurboCodec *(*turbo_codec_make_fn)(int, bool, int, bool, bool,
+		                                           int, const std::string &,
+		                                           int, int, int, bool, bool,
+		                                           const std::string &, float,
+		                                           bool);
+
+		/* SIMD level the codec kernels are built for */
+		struct turbo_codec_isa {
+			const char *name;
+			bool (*supported)(); /* whether the host can run the level */
+			turbo_codec_make_fn make;
+			int (*lanes)(int precision); /* LLRs per register, 0 if not implemented */
+		};
+
+#ifdef TURBO_CODEC_HAVE_AVX512
+		static bool
+		turbo_cpu_has_avx512()
+		{
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx512f") &&
+			       __builtin_cpu_supports("avx512bw") &&
+			       __builtin_cpu_supports("avx512vl") &&
+			       __builtin_cpu_supports("avx512dq") &&
+			       __builtin_cpu_supports("fma");
+		}
+#endif
+
+#ifdef TURBO_CODEC_HAVE_AVX2
+		static bool
+		turbo_cpu_has_avx2()
+		{
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2") &&
+			       __builtin_cpu_supports("fma");
+		}
+#endif
+
+#ifdef TURBO_CODEC_HAVE_SSE41
+		static bool
+		turbo_cpu_has_sse41()
+		{
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("sse4.1");
+		}
+#endif
+
+#ifdef TURBO_CODEC_HAVE_SSE2
+		static bool
+		turbo_cpu_has_sse2()
+		{
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("sse2");
+		}
+#endif
+
+#ifdef TURBO_CODEC_HAVE_GENERIC
+		/* Built with the compiler's default target */
+		static bool
+		turbo_cpu_has_generic()
+		{
+			return true;
+		}
+#endif
+
+		/* Levels built into the library, from the highest to the lowest */
+		static const turbo_codec_isa turbo_codec_isas[] = {
+#ifdef TURBO_CODEC_HAVE_AVX512
+			{"avx512", turbo_cpu_has_avx512, avx512::make_codec, avx512::simd_lanes},
+#endif
+#ifdef TURBO_CODEC_HAVE_AVX2
+			{"avx2",   turbo_cpu_has_avx2,   avx2::make_codec,   avx2::simd_lanes},
+#endif
+#ifdef TURBO_CODEC_HAVE_SSE41
+			{"sse4.1", turbo_cpu_has_sse41,  sse41::make_codec,  sse41::simd_lanes},
+#endif
+#ifdef TURBO_CODEC_HAVE_SSE2
+			{"sse2",   turbo_cpu_has_sse2,   sse2::make_codec,   sse2::simd_lanes},
+#endif
+#ifdef TURBO_CODEC_HAVE_GENERIC
+			{"generic", turbo_cpu_has_generic, generic::make_codec, generic::simd_lanes},
+#endif
+		};
+
+		static const int n_turbo_codec_isas = sizeof(turbo_codec_isas) /
+		                                      sizeof(turbo_codec_isas[0]);
+
+		/*
+		 * Select the highest level supported by the host or, if the
+		 * BLOCKSAT_SIMD environment variable names a level, the highest
+		 * supported level that is not above it.
+		 */
+		static int
+		turbo_codec_select_isa()
+		{
+			const char *forced = getenv("BLOCKSAT_SIMD");
+			int i_start        = 0;
+
+			if (forced && *forced) {
+				while (i_start < n_turbo_codec_isas &&
+				       std::string(turbo_codec_isas[i_start].name) != forced)
+					i_start++;
+				if (i_start == n_turbo_codec_isas) {
+					fprintf(stderr, "turbo_decoder: ignoring unknown "
+					        "BLOCKSAT_SIMD level \"%s\"\n", forced);
+					i_start = 0;
+				}
+			}
+
+			for (int i = i_start; i < n_turbo_codec_isas; i++)
+				if (turbo_codec_isas[i].supported())
+					return i;
+
+			throw std::runtime_error("turbo_decoder: the CPU supports none of "
+			                         "the SIMD levels the decoder was built "
+			                         "for");
+		}
+
+		static int
+		turbo_codec_get_isa()
+		{
+			/* Selected once, on first use */
+			static const int i_isa = turbo_codec_select_isa();
+			return i_isa;
+		}
+
+		std::string
+		turbo_codec_simd_level()
+		{
+			return turbo_codec_isas[turbo_codec_get_isa()].name;
+		}
+
+		/*
+		 * Whether an intra-frame codec with the given SIMD lanes can
+		 * decode the codeword: the SISOs require K and the window length
+		 * to be multiples of the lanes, and each sub-block to span at
+		 * least one register
+		 */
+		static bool
+		turbo_codec_fits(int lanes, int K, int window_len, int n_sub_blocks)
+		{
+			return (K % lanes) == 0 && (window_len % lanes) == 0 &&
+			       n_sub_blocks <= K / lanes;
+		}
+
+		TurboCodec *
+		TurboCodec::make(int K, bool pct_en, int n_ite, bool flip_llrs,
+		                 bool inter_frame, int precision,
+		                 const std::string &crc, int window_len,
+		                 int training_len, int n_sub_blocks,
+		                 bool radix4, bool pack_bits,
+		                 const std::string &max_op, float ext_scale,
+		                 bool hd_stop)
+		{
+			if (window_len < 0)
+				throw std::runtime_error("turbo_decoder: window_len must be "
+				                         ">= 0");
+
+			if (window_len > 0 && inter_frame)
+				throw std::runtime_error("turbo_decoder: the sliding-window "
+				                         "BCJR is not available in inter-frame "
+				                         "mode");
+
+			if (n_sub_blocks < 1)
+				throw std::runtime_error("turbo_decoder: n_sub_blocks must be "
+				                         ">= 1");
+
+			if (n_sub_blocks > 1 && (inter_frame || window_len > 0))
+				throw std::runtime_error("turbo_decoder: the sub-block BCJR "
+				                         "can't be combined with inter-frame "
+				                         "mode or the sliding-window BCJR");
+
+			if (radix4 && (inter_frame || window_len > 0 || n_sub_blocks > 1))
+				throw std::runtime_error("turbo_decoder: the radix-4 BCJR "
+				                         "can't be combined with inter-frame "
+				                         "mode, the sliding-window or the "
+				                         "sub-block BCJR");
+
+			if (max_op != "max" && max_op != "max_star" &&
+			    max_op != "max_linear")
+				throw std::runtime_error("turbo_decoder: max_op must be "
+				                         "\"max\", \"max_star\" or "
+				                         "\"max_linear\"");
+
+			if (max_op != "max" && precision != 32)
+				throw std::runtime_error("turbo_decoder: the max_star and "
+				                         "max_linear operators require 32-bit "
+				                         "precision");
+
+			if (!(ext_scale > 0.0f))
+				throw std::runtime_error("turbo_decoder: ext_scale must be "
+				                         "> 0");
+
+			if (pack_bits && (K % 8) != 0)
+				throw std::runtime_error("turbo_decoder: packed output requires "
+				                         "K to be a multiple of 8");
+
+			if (precision != 32 && precision != 16)
+				throw std::runtime_error("turbo_decoder: precision must be 32 "
+				                         "or 16 bits");
+
+			/* Not all levels implement all precisions (e.g. mipp lacks the
+			 * 16-bit AVX-512 operations). Besides, the intra-frame
+			 * SISOs process the trellis, its windows and its sub-blocks in
+			 * whole SIMD registers, which the codeword may not fill at the
+			 * wider levels (e.g. K = 40 with 16 float lanes). The highest
+			 * lower level implementing the precision and fitting the
+			 * codeword is used instead. */
+			int min_lanes = 0; /* of the lowest level implementing it */
+			for (int i = turbo_codec_get_isa(); i < n_turbo_codec_isas; i++) {
+				const turbo_codec_isa &isa = turbo_codec_isas[i];
+				if (!isa.supported())
+					continue;
+
+				const int lanes = isa.lanes(precision);
+				if (lanes == 0)
+					continue;
+				min_lanes = lanes;
+				if (!inter_frame && !turbo_codec_fits(lanes, K, window_len,
+				                                      n_sub_blocks))
+					continue;
+
+				TurboCodec *codec = isa.make(K, pct_en, n_ite, flip_llrs,
+				                             inter_frame, precision, crc,
+				                             window_len, training_len,
+				                             n_sub_blocks, radix4,
+				                             pack_bits, max_op, ext_scale,
+				                             hd_stop);
+				if (codec) {
+					codec->d_simd_level = isa.name;
+					return codec;
+				}
+			}
+
+			if (min_lanes == 0)
+				throw std::runtime_error("turbo_decoder: fixed-point decoding "
+				                         "requires SSE4.1 or later SIMD "
+				                         "extensions");
+
+			/* Not even the narrowest registers fit */
+			const std::string lanes = std::to_string(min_lanes);
+			const std::string prec  = std::to_string(precision);
+			if (K % min_lanes)
+				throw std::runtime_error("turbo_decoder: intra-frame decoding "
+				                         "with " + prec + "-bit LLRs requires "
+				                         "K to be a multiple of " + lanes);
+			if (window_len % min_lanes)
+				throw std::runtime_error("turbo_decoder: window_len must be a "
+				                         "multiple of " + lanes + " with " +
+				                         prec + "-bit LLRs");
+			throw std::runtime_error("turbo_decoder: n_sub_blocks must be at "
+			                         "most K / " + lanes + " with " + prec +
+			                         "-bit LLRs");
+		}
+
+		TurboCodec::~TurboCodec()
+		{
+		}
+
+		void
+		TurboCodec::collect_stats(turbo_codec_stats &stats)
+		{
+			for (unsigned int i = 0; i < d_stats.ite_hist.size(); i++) {
+				stats.ite_hist[i] += d_stats.ite_hist[i];
+				d_stats.ite_hist[i] = 0;
+			}
+			stats.n_failures  += d_stats.n_failures;
+			stats.time_sum_ns += d_stats.time_sum_ns;
+			stats.time_max_ns  = std::max(stats.time_max_ns,
+			                              d_stats.time_max_ns);
+			d_stats.n_failures  = 0;
+			d_stats.time_sum_ns = 0;
+			d_stats.time_max_ns = 0;
+		}
+
+		TurboCodecPool::TurboCodecPool(int n_threads, int K, bool pct_en,
+		                               int n_ite, bool flip_llrs,
+		                               bool inter_frame, int precision,
+		                               const std::string &crc,
+		                               int window_len, int training_len,
+		                               int n_sub_blocks, bool radix4,
+		                               bool pack_bits,
+		                               const std::string &max_op,
+		                               float ext_scale, bool hd_stop)
+			: d_job_seq(0),
+			  d_n_pending(0),
+			  d_stop(false),
+			  d_n_threads(n_threads)
+		{
+			if (n_threads < 1)
+				throw std::runtime_error("turbo_decoder: n_threads must be >= 1");
+
+			/* The vectors are reserved upfront, such that storing a codec
+			 * or a started worker can't throw */
+			d_codecs.reserve(n_threads);
+			d_workers.reserve(n_threads - 1);
+			d_jobs.resize(n_threads);
+
+			try {
+				/* Each thread owns a complete set of decoding modules */
+				for (int i = 0; i < n_threads; i++)
+					d_codecs.push_back(TurboCodec::make(K, pct_en, n_ite,
+					                                    flip_llrs,
+					                                    inter_frame,
+					                                    precision, crc,
+					                                    window_len,
+					                                    training_len,
+					                                    n_sub_blocks,
+					                                    radix4, pack_bits,
+					                                    max_op, ext_scale,
+					                                    hd_stop));
+
+				for (int i = 1; i < n_threads; i++)
+					d_workers.push_back(std::thread(&TurboCodecPool::worker,
+					                                this, i));
+			} catch (...) {
+				shutdown();
+				throw;
+			}
+		}
+
+		TurboCodecPool::~TurboCodecPool()
+		{
+			shutdown();
+		}
+
+		/*
+		 * Stop and join the workers started so far and free the codecs
+		 */
+		void
+		TurboCodecPool::shutdown()
+		{
+			{
+				std::lock_guard<std::mutex> lock(d_mutex);
+				d_stop = true;
+			}
+			d_cv_start.notify_all();
+			for (auto &t : d_workers)
+				t.join();
+
+			for (auto codec : d_codecs)
+				delete codec;
+		}
+
+		/*
+		 * Decoding worker loop: waits for a new job dispatch, decodes its
+		 * assigned range of codewords and signals completion.
+		 */
+		void
+		TurboCodecPool::worker(int id)
+		{
+			unsigned int seq = 0;
+
+			while (true) {
+				std::unique_lock<std::mutex> lock(d_mutex);
+				d_cv_start.wait(lock, [&]{ return d_stop || d_job_seq != seq; });
+				if (d_stop)
+					return;
+				seq = d_job_seq;
+				turbo_dec_job job = d_jobs[id];
+				lock.unlock();
+
+				if (job.n_codewords > 0)
+					d_codecs[id]->decode(job.in, job.out, job.n_codewords,
+					                     job.failed);
+
+				lock.lock();
+				if (--d_n_pending == 0)
+					d_cv_done.notify_one();
+			}
+		}
+
+		void
+		TurboCodecPool::decode(const float *in, unsigned char *out,
+		                       int n_codewords, unsigned char *failed)
+		{
+			const int N       = get_N();
+			const int out_len = get_out_len();
+
+			/* Split the codewords into contiguous ranges, one per thread.
+			 * Ranges are multiples of the SIMD batch size, such that only
+			 * the last range can end with a partial batch. Each thread
+			 * writes into its own section of the output buffer, so that the
+			 * output order matches the input order. */
+			const int n_frames    = get_n_frames();
+			const int n_batches   = (n_codewords + n_frames - 1) / n_frames;
+			const int cw_per_job  = ((n_batches + d_n_threads - 1) /
+			                         d_n_threads) * n_frames;
+
+			for (int i = 0; i < d_n_threads; i++) {
+				int i_start = std::min(i * cw_per_job, n_codewords);
+				int i_end   = std::min(i_start + cw_per_job, n_codewords);
+				d_jobs[i].in          = in + (i_start * N);
+				d_jobs[i].out         = out + (i_start * out_len);
+				d_jobs[i].failed      = failed ? failed + i_start : NULL;
+				d_jobs[i].n_codewords = i_end - i_start;
+			}
+
+			if (d_n_threads > 1) {
+				std::lock_guard<std::mutex> lock(d_mutex);
+				d_n_pending = d_n_threads - 1;
+				d_job_seq++;
+			}
+			d_cv_start.notify_all();
+
+			if (d_jobs[0].n_codewords > 0)
+				d_codecs[0]->decode(d_jobs[0].in, d_jobs[0].out,
+				                    d_jobs[0].n_codewords, d_jobs[0].failed);
+
+			std::unique_lock<std::mutex> lock(d_mutex);
+			d_cv_done.wait(lock, [&]{ return d_n_pending == 0; });
+		}
+
+		void
+		TurboCodecPool::collect_stats(turbo_codec_stats &stats)
+		{
+			for (auto codec : d_codecs)
+				codec->collect_stats(stats);
+		}
+
+		TurboRedecoder::TurboRedecoder(int queue_len, int K, bool pct_en,
+		                               int n_ite, bool flip_llrs,
+		                               const std::string &crc,
+		                               bool pack_bits,
+		                               recovered_fn on_recovered)
+			: d_codec(NULL),
+			  d_on_recovered(on_recovered),
+			  d_queue_len(queue_len),
+			  d_head(0),
+			  d_count(0),
+			  d_stop(false)
+		{
+			if (crc.empty())
+				throw std::runtime_error("turbo_decoder: second-chance decoding requires a CRC");
+			if (queue_len < 1)
+				throw std::runtime_error("turbo_decoder: redec_queue_len must be >= 1");
+
+			/* Latency is no concern here: one codeword at a time, floating
+			 * point and log-MAP */
+			d_codec = TurboCodec::make(K, pct_en, n_ite, flip_llrs, false, 32,
+			                           crc, 0, 32, 1, false, pack_bits,
+			                           "max_star", 1.0, false);
+			d_llrs.resize(queue_len * d_codec->get_N());
+			d_offsets.resize(queue_len);
+
+			d_thread = std::thread(&TurboRedecoder::worker, this);
+		}
+
+		TurboRedecoder::~TurboRedecoder()
+		{
+			{
+				std::lock_guard<std::mutex> lock(d_mutex);
+				d_stop = true;
+			}
+			d_cv.notify_one();
+			d_thread.join();
+
+			delete d_codec;
+		}
+
+		bool
+		TurboRedecoder::push(const float *in, uint64_t offset)
+		{
+			const int N = d_codec->get_N();
+			{
+				std::lock_guard<std::mutex> lock(d_mutex);
+				if (d_count == d_queue_len)
+					return false;
+
+				const int slot = (d_head + d_count) % d_queue_len;
+				std::memcpy(&d_llrs[slot * N], in, N * sizeof(float));
+				d_offsets[slot] = offset;
+				d_count++;
+			}
+			d_cv.notify_one();
+			return true;
+		}
+
+		/*
+		 * Background loop: decodes the queued codewords, oldest first. Each
+		 * codeword is copied out of the queue before decoding, such that
+		 * push never waits for a decoding to complete.
+		 */
+		void
+		TurboRedecoder::worker()
+		{
+#ifdef __linux__
+			/* Only run when the CPU would otherwise be idle */
+			struct sched_param param;
+			param.sched_priority = 0;
+			pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+			const int N = d_codec->get_N();
+			std::vector<float> in(N);
+			std::vector<unsigned char> out(d_codec->get_out_len());
+			turbo_codec_stats stats;
+			stats.ite_hist.assign(d_codec->get_n_ite() + 1, 0);
+			stats.n_failures  = 0;
+			stats.time_sum_ns = 0;
+			stats.time_max_ns = 0;
+
+			while (true) {
+				uint64_t offset;
+				{
+					std::unique_lock<std::mutex> lock(d_mutex);
+					d_cv.wait(lock, [&]{ return d_stop || d_count > 0; });
+					if (d_stop)
+						return;
+					std::memcpy(in.data(), &d_llrs[d_head * N],
+					            N * sizeof(float));
+					offset  = d_offsets[d_head];
+					d_head  = (d_head + 1) % d_queue_len;
+					d_count--;
+				}
+
+				unsigned char failed;
+				d_codec->decode(in.data(), out.data(), 1, &failed);
+
+				/* Single codeword: its iterations are the only non-empty
+				 * bin of the histogram */
+				d_codec->collect_stats(stats);
+				int n_ite = 0;
+				for (unsigned int i = 0; i < stats.ite_hist.size(); i++) {
+					if (stats.ite_hist[i] > 0)
+						n_ite = i;
+					stats.ite_hist[i] = 0;
+				}
+
+				if (!failed)
+					d_on_recovered(offset, out.data(), n_ite);
+			}
+		}
+
+	} /* namespace blocksat */
+} /* namespace gr */
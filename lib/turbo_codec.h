@@ -0,0 +1,278 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Blockstream Corp.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_BLOCKSAT_TURBO_CODEC_H
+#define INCLUDED_BLOCKSAT_TURBO_CODEC_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gr {
+	namespace blocksat {
+
+		/*
+		 * \brief SIMD level of the turbo codec kernels selected for this host
+		 *
+		 * The kernels are built for several SIMD levels ("sse2", "sse4.1",
+		 * "avx2" and "avx512" on x86, "generic" elsewhere) and the highest
+		 * level supported by the CPU is selected on first use. The
+		 * BLOCKSAT_SIMD environment variable can select a lower level.
+		 * Codecs whose precision is not implemented at the selected level,
+		 * or whose codeword doesn't fill its SIMD registers (see
+		 * TurboCodec::make), use the highest lower level that fits.
+		 */
+		std::string turbo_codec_simd_level();
+
+		/* Decoding statistics of a codec, accumulated until collected */
+		struct turbo_codec_stats {
+			std::vector<uint64_t> ite_hist; /* codewords per n. of iterations */
+			uint64_t n_failures;  /* codewords that failed the CRC or didn't converge */
+			uint64_t time_sum_ns; /* decoding time summed over the codewords */
+			uint64_t time_max_ns; /* longest decoding time of a codeword */
+		};
+
+		/*
+		 * Complete set of aff3ct modules and scratch buffers needed to decode
+		 * turbo codewords. The modules keep internal state while decoding, so
+		 * each decoding thread must own a separate TurboCodec. The interface
+		 * is independent of the SIMD level the codec is built for.
+		 */
+		class TurboCodec
+		{
+		protected:
+			int d_K;
+			int d_N;
+			int d_out_len;  /* output bytes per codeword */
+			int d_n_frames; /* codewords decoded per batch (SIMD lanes) */
+			int d_n_valid;  /* codewords of the current batch (the rest is padding) */
+			const char *d_simd_level; /* level of the kernels, set by make */
+			turbo_codec_stats d_stats;
+
+			/* Account the decoding time of n_codewords decoded together */
+			void add_decode_time(uint64_t ns, int n_codewords)
+			{
+				d_stats.time_sum_ns += ns * n_codewords;
+				d_stats.time_max_ns  = std::max(d_stats.time_max_ns, ns);
+			}
+
+		public:
+			virtual ~TurboCodec();
+
+			/*
+			 * \brief Construct the codec for the given LLR precision, using
+			 *        the kernels of the SIMD level selected for this host
+			 *
+			 * Intra-frame codecs require K and window_len to be multiples
+			 * of the LLRs per SIMD register, and n_sub_blocks to be at most
+			 * K over them. When the selected level doesn't fit, the
+			 * highest lower level that does is used.
+			 *
+			 * \param K dataword length
+			 * \param pct_en Enable depuncturer
+			 * \param n_ite maximum number of iterations
+			 * \param flip_llrs Invert the sign of the input LLRs
+			 * \param inter_frame Decode one codeword per SIMD lane
+			 * \param precision Bits per LLR inside the decoder (32 or 16)
+			 * \param crc CRC polynomial carried by the last bits of each
+			 *        dataword, used to stop iterating early ("" to disable)
+			 * \param window_len Stages per window of the sliding-window BCJR
+			 *        (0 to process the whole trellis at once)
+			 * \param training_len Training stages of the sliding-window BCJR
+			 * \param n_sub_blocks Sub-blocks of each trellis decoded in
+			 *        parallel (1 to decode the trellis on a single thread)
+			 * \param radix4 Use the radix-4 BCJR (two stages per step)
+			 * \param pack_bits Output 8 decoded bits per byte (MSB first)
+			 *        instead of one bit per byte
+			 * \param max_op Max operator of the BCJR: "max" (max-log-MAP),
+			 *        "max_star" (log-MAP) or "max_linear" (linear
+			 *        approximation of the log-MAP correction)
+			 * \param ext_scale Scaling factor of the extrinsic LLRs
+			 * \param hd_stop Stop iterating on a codeword once its hard
+			 *        decisions are unchanged over an iteration
+			 */
+			static TurboCodec *make(int K, bool pct_en, int n_ite,
+			                        bool flip_llrs, bool inter_frame,
+			                        int precision, const std::string &crc,
+			                        int window_len, int training_len,
+			                        int n_sub_blocks, bool radix4,
+			                        bool pack_bits, const std::string &max_op,
+			                        float ext_scale, bool hd_stop);
+
+			/*
+			 * \brief Decode contiguous codewords
+			 * \param in Pointer to the n_codewords * N input LLRs
+			 * \param out Pointer to the n_codewords * get_out_len() output
+			 *        bytes
+			 * \param n_codewords Number of codewords to decode
+			 * \param failed Optional pointer to n_codewords flags, set for
+			 *        the codewords that failed decoding (see collect_stats)
+			 */
+			virtual void decode(const float *in, unsigned char *out,
+			                    int n_codewords,
+			                    unsigned char *failed = NULL) = 0;
+
+			int get_K() const { return d_K; }
+			int get_N() const { return d_N; }
+			int get_out_len() const { return d_out_len; }
+			int get_n_frames() const { return d_n_frames; }
+			int get_n_ite() const { return (int)d_stats.ite_hist.size() - 1; }
+			std::string get_simd_level() const { return d_simd_level; }
+
+			/*
+			 * \brief Accumulate the statistics into stats and reset them
+			 *
+			 * Bin i of the histogram counts the codewords decoded in i
+			 * iterations. Failures are only detected with a CRC or with
+			 * hd_stop. The decoding time of a codeword is the time from
+			 * its load into the decoder until its output, i.e. that of the
+			 * whole batch when decoding batches. Must not be called while
+			 * the codec is decoding.
+			 */
+			void collect_stats(turbo_codec_stats &stats);
+		};
+
+		/* Contiguous range of codewords assigned to a decoding thread */
+		struct turbo_dec_job {
+			const float *in;
+			unsigned char *out;
+			unsigned char *failed;
+			int n_codewords;
+		};
+
+		/*
+		 * Set of codecs decoding contiguous codewords in parallel, one per
+		 * thread. The calling thread decodes the first range of codewords
+		 * itself, the others are decoded by n_threads - 1 persistent workers.
+		 */
+		class TurboCodecPool
+		{
+		private:
+			std::vector<TurboCodec*> d_codecs; /* one per thread */
+			std::vector<std::thread> d_workers;
+			std::vector<turbo_dec_job> d_jobs;
+			std::mutex d_mutex;
+			std::condition_variable d_cv_start;
+			std::condition_variable d_cv_done;
+			unsigned int d_job_seq; /* incremented on every job dispatch */
+			int d_n_pending;        /* workers yet to finish their job */
+			bool d_stop;
+			int d_n_threads;
+
+			void worker(int id);
+			void shutdown();
+
+		public:
+			/*
+			 * \param n_threads Number of decoding threads
+			 * The other parameters are those of TurboCodec::make.
+			 */
+			TurboCodecPool(int n_threads, int K, bool pct_en, int n_ite,
+			               bool flip_llrs, bool inter_frame, int precision,
+			               const std::string &crc, int window_len,
+			               int training_len, int n_sub_blocks, bool radix4,
+			               bool pack_bits, const std::string &max_op,
+			               float ext_scale, bool hd_stop);
+			~TurboCodecPool();
+
+			/*
+			 * \brief Decode contiguous codewords, preserving their order
+			 * \param in Pointer to the n_codewords * get_N() input LLRs
+			 * \param out Pointer to the n_codewords * get_out_len() output
+			 *        bytes
+			 * \param failed Optional pointer to n_codewords failure flags
+			 */
+			void decode(const float *in, unsigned char *out, int n_codewords,
+			            unsigned char *failed = NULL);
+
+			/*
+			 * \brief Accumulate the statistics of all codecs into stats and
+			 *        reset them. Must not be called while decoding.
+			 */
+			void collect_stats(turbo_codec_stats &stats);
+
+			int get_K() const { return d_codecs[0]->get_K(); }
+			int get_N() const { return d_codecs[0]->get_N(); }
+			int get_out_len() const { return d_codecs[0]->get_out_len(); }
+			int get_n_frames() const { return d_codecs[0]->get_n_frames(); }
+			int get_n_threads() const { return d_n_threads; }
+			std::string get_simd_level() const { return d_codecs[0]->get_simd_level(); }
+		};
+
+		/*
+		 * Second-chance decoder: codewords that failed their CRC online are
+		 * queued (bounded) and decoded again by a low-priority background
+		 * thread, with many more iterations and the log-MAP BCJR. The
+		 * codewords that then pass the CRC are handed to on_recovered.
+		 */
+		class TurboRedecoder
+		{
+		public:
+			/* Called from the background thread with the stream offset
+			 * given to push, the decoded bytes and the iterations used */
+			typedef std::function<void(uint64_t offset,
+			                           const unsigned char *out,
+			                           int n_ite)> recovered_fn;
+
+		private:
+			TurboCodec *d_codec;
+			recovered_fn d_on_recovered;
+			std::vector<float> d_llrs;      /* queue_len slots of N LLRs */
+			std::vector<uint64_t> d_offsets;
+			int d_queue_len;
+			int d_head;  /* oldest slot */
+			int d_count; /* queued codewords */
+			std::mutex d_mutex;
+			std::condition_variable d_cv;
+			bool d_stop;
+			std::thread d_thread;
+
+			void worker();
+
+		public:
+			/*
+			 * \param queue_len Maximum number of queued codewords
+			 * \param n_ite Iterations of the second-chance decoding
+			 * The other parameters are those of TurboCodec::make used for
+			 * the online decoding. A CRC is required.
+			 */
+			TurboRedecoder(int queue_len, int K, bool pct_en, int n_ite,
+			               bool flip_llrs, const std::string &crc,
+			               bool pack_bits, recovered_fn on_recovered);
+			~TurboRedecoder();
+
+			/*
+			 * \brief Queue a codeword for decoding
+			 * \param in Pointer to the N input LLRs (copied)
+			 * \param offset Stream offset passed back on recovery
+			 * \return False if the queue is full (codeword dropped)
+			 */
+			bool push(const float *in, uint64_t offset);
+		};
+
+	} // namespace blocksat
+} // namespace gr
+
+#endif /* INCLUDED_BLOCKSAT_TURBO_CODEC_H */
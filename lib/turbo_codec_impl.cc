@@ -0,0 +1,1176 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Blockstream Corp.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "turbo_codec_impl.h"
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+#undef DEBUG_DEC
+
+/* The fixed-point kernels rely on 8 and 16-bit SIMD instructions that mipp
+ * only implements from SSE4.1 onwards on x86 */
+#if defined(MIPP_BW) && !(defined(MIPP_SSE) && MIPP_INSTR_VERSION < 41)
+#define TURBO_CODEC_FIXED_POINT
+#endif
+
+namespace gr {
+	namespace blocksat {
+	namespace TURBO_CODEC_ISA {
+
+		typedef std::chrono::steady_clock turbo_clock;
+
+		static inline uint64_t
+		turbo_elapsed_ns(turbo_clock::time_point t0)
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>
+				(turbo_clock::now() - t0).count();
+		}
+
+		/*
+		 * Fixed-point format of the LLRs for each precision: input LLRs are
+		 * rounded to saturation_pos bits, of which fixed_point_pos are
+		 * fractional bits. The extrinsic LLRs are saturated to ext_sat such
+		 * that the sum of systematic and extrinsic LLRs can't overflow
+		 * within the BCJR.
+		 */
+		template <typename Q>
+		struct turbo_codec_qnt
+		{
+			static constexpr bool fixed_point  = false;
+			static constexpr int fixed_point_pos = 0;
+			static constexpr int saturation_pos  = 0;
+			static constexpr Q ext_sat           = 0;
+		};
+
+		template <>
+		struct turbo_codec_qnt <short>
+		{
+			static constexpr bool fixed_point  = true;
+			static constexpr int fixed_point_pos = 2;
+			static constexpr int saturation_pos  = 6;
+			static constexpr short ext_sat       = 1023;
+		};
+
+		/*
+		 * Pack hard decisions (zero or non-zero) into bytes, MSB first. The
+		 * SSSE3 kernel narrows 16 decisions to bytes, reverses their order
+		 * within each group of 8 and collects them with a byte movemask.
+		 */
+#ifdef __SSSE3__
+		static inline __m128i
+		turbo_load_16_bits(const int8_t *bits)
+		{
+			return _mm_loadu_si128((const __m128i*)bits);
+		}
+
+		static inline __m128i
+		turbo_load_16_bits(const int16_t *bits)
+		{
+			return _mm_packs_epi16(_mm_loadu_si128((const __m128i*)bits),
+			                       _mm_loadu_si128((const __m128i*)(bits + 8)));
+		}
+
+		static inline __m128i
+		turbo_load_16_bits(const int32_t *bits)
+		{
+			const __m128i lo = _mm_packs_epi32(_mm_loadu_si128((const __m128i*)bits),
+			                                   _mm_loadu_si128((const __m128i*)(bits + 4)));
+			const __m128i hi = _mm_packs_epi32(_mm_loadu_si128((const __m128i*)(bits + 8)),
+			                                   _mm_loadu_si128((const __m128i*)(bits + 12)));
+			return _mm_packs_epi16(lo, hi);
+		}
+#endif
+
+		template <typename B>
+		static inline void
+		turbo_pack_bits(const B *bits, unsigned char *out, int n_bytes)
+		{
+			int j = 0;
+#ifdef __SSSE3__
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i rev  = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15,
+			                                  0, 1,  2,  3,  4,  5,  6,  7);
+			for (; j + 1 < n_bytes; j += 2) {
+				const __m128i v = _mm_shuffle_epi8(turbo_load_16_bits(bits + 8 * j), rev);
+				const int m = ~_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero));
+				out[j]     = (unsigned char)m;
+				out[j + 1] = (unsigned char)(m >> 8);
+			}
+#endif
+			for (; j < n_bytes; j++) {
+				unsigned char byte = 0;
+				for (int k = 0; k < 8; k++)
+					byte |= (bits[8 * j + k] != 0) << (7 - k);
+				out[j] = byte;
+			}
+		}
+
+		/*
+		 * Scale the extrinsic LLRs, rounding to nearest with fixed-point LLRs
+		 */
+		template <typename Q>
+		static inline void
+		turbo_codec_scale(mipp::vector<Q> &ext, float factor)
+		{
+			for (unsigned int i = 0; i < ext.size(); i++)
+				ext[i] = (Q)std::round(ext[i] * factor);
+		}
+
+		template <>
+		inline void
+		turbo_codec_scale<float>(mipp::vector<float> &ext, float factor)
+		{
+			const mipp::Reg<float> r_factor = factor;
+			const int vec_size = (ext.size() / mipp::nElReg<float>()) *
+			                     mipp::nElReg<float>();
+			int i = 0;
+			for (; i < vec_size; i += mipp::nElReg<float>())
+				(mipp::Reg<float>(&ext[i]) * r_factor).store(&ext[i]);
+			for (; i < (int)ext.size(); i++)
+				ext[i] *= factor;
+		}
+
+		TurboCodec *
+		make_codec(int K, bool pct_en, int n_ite, bool flip_llrs,
+		           bool inter_frame, int precision, const std::string &crc,
+		           int window_len, int training_len, int n_sub_blocks,
+		           bool radix4, bool pack_bits, const std::string &max_op,
+		           float ext_scale, bool hd_stop)
+		{
+			switch (precision) {
+			case 32:
+				return new TurboCodecImpl<B_32,Q_32,QD_32>(K, pct_en, n_ite,
+				                                           flip_llrs,
+				                                           inter_frame,
+				                                           crc, window_len,
+				                                           training_len,
+				                                           n_sub_blocks, radix4,
+				                                           pack_bits, max_op,
+				                                           ext_scale, hd_stop);
+#ifdef TURBO_CODEC_FIXED_POINT
+			case 16:
+				return new TurboCodecImpl<B_16,Q_16,QD_16>(K, pct_en, n_ite,
+				                                           flip_llrs,
+				                                           inter_frame,
+				                                           crc, window_len,
+				                                           training_len,
+				                                           n_sub_blocks, radix4,
+				                                           pack_bits, max_op,
+				                                           ext_scale, hd_stop);
+#else
+			case 16:
+				/* Not implemented at this level, TurboCodec::make falls back
+				 * to a lower one */
+				return NULL;
+#endif
+			default:
+				throw std::runtime_error("turbo_decoder: precision must be 32 "
+				                         "or 16 bits");
+			}
+		}
+
+		int
+		simd_lanes(int precision)
+		{
+			switch (precision) {
+			case 32:
+				return mipp::nElReg<Q_32>();
+#ifdef TURBO_CODEC_FIXED_POINT
+			case 16:
+				return mipp::nElReg<Q_16>();
+#endif
+			default:
+				return 0;
+			}
+		}
+
+		template <typename B, typename Q>
+		TurboDecoderFused<B,Q>::TurboDecoderFused(int K, int N_cw, int n_ite,
+		                                          const module::Interleaver<int> &pi,
+		                                          module::Decoder_SISO<Q> &siso_n,
+		                                          module::Decoder_SISO<Q> &siso_i,
+		                                          int N,
+		                                          const module::Puncturer_turbo<B_32,Q_32> *pct,
+		                                          bool flip_llrs,
+		                                          int fixed_point_pos,
+		                                          int saturation_pos)
+			: module::Decoder_turbo_fast<B,Q>(K, N_cw, n_ite, pi, siso_n, siso_i),
+			  d_N(N),
+			  d_factor((flip_llrs ? -1.0f : 1.0f) * (float)(1 << fixed_point_pos)),
+			  d_val_max(saturation_pos ? (float)((1 << (saturation_pos - 1)) - 1) : 0.0f),
+			  d_fixed_point(saturation_pos > 0),
+			  d_tail_n_2(siso_n.tail_length() / 2),
+			  d_tail_i_2(siso_i.tail_length() / 2),
+			  d_decode(&TurboDecoderFused::template decode_static<module::Decoder_SISO<Q>>),
+			  d_iterate(&TurboDecoderFused::template iterate_static<module::Decoder_SISO<Q>>)
+		{
+			/* Depunctured position -> input index. The map is obtained by
+			 * depuncturing the (1-based) input indexes themselves, such that
+			 * it always follows the layout of the puncturer. */
+			std::vector<int> dpct(N_cw);
+			if (pct) {
+				std::vector<float> idx(N), idx_dpct(N_cw);
+				for (int i = 0; i < N; i++)
+					idx[i] = (float)(i + 1);
+				pct->depuncture(idx.data(), idx_dpct.data());
+				for (int i = 0; i < N_cw; i++)
+					dpct[i] = (int)idx_dpct[i] - 1;
+			} else {
+				for (int i = 0; i < N_cw; i++)
+					dpct[i] = i;
+			}
+
+			/* Decoder buffer position -> depunctured position, as in
+			 * Decoder_turbo::buffered_load */
+			const int tail_n       = siso_n.tail_length();
+			const int tail_i       = siso_i.tail_length();
+			const int N_without_tb = N_cw - (tail_n + tail_i);
+			const int p_size       = (N_without_tb - K) / 2;
+
+			d_map_sn.resize(K + tail_n / 2);
+			d_map_pn.resize(p_size + tail_n / 2);
+			d_map_si.resize(K + tail_i / 2);
+			d_map_pi.resize(p_size + tail_i / 2);
+
+			for (int i = 0; i < K; i++)
+				d_map_sn[i] = dpct[i];
+			for (int i = 0; i < p_size; i++) {
+				d_map_pn[i] = dpct[K + i];
+				d_map_pi[i] = dpct[K + p_size + i];
+			}
+			for (int i = 0; i < tail_n / 2; i++) {
+				d_map_pn[p_size + i] = dpct[N_without_tb + i];
+				d_map_sn[K + i]      = dpct[N_without_tb + tail_n / 2 + i];
+			}
+			for (int i = 0; i < tail_i / 2; i++) {
+				d_map_pi[p_size + i] = dpct[N_without_tb + tail_n + i];
+				d_map_si[K + i]      = dpct[N_without_tb + tail_n + tail_i / 2 + i];
+			}
+
+			/* The interleaved systematic LLRs are read straight from the
+			 * input rather than from the natural domain buffer */
+			const std::vector<int> &lut = pi.get_lut();
+			for (int i = 0; i < K; i++)
+				d_map_si[i] = d_map_sn[lut[i]];
+
+			/* The punctured positions read the zero LLR past the codeword */
+			for (std::vector<int> *map : {&d_map_sn, &d_map_pn, &d_map_si, &d_map_pi})
+				for (int &m : *map)
+					if (m < 0)
+						m = N;
+			d_llrs.resize(N + 1, (Q)0);
+
+			d_runs_sn = make_runs(d_map_sn);
+			d_runs_pn = make_runs(d_map_pn);
+			d_runs_si = make_runs(d_map_si);
+			d_runs_pi = make_runs(d_map_pi);
+		}
+
+		/*
+		 * Split a buffer map into runs: stretches of at least 16 contiguous
+		 * input indexes become copies, the rest is gathered. Unpunctured,
+		 * the systematic and parity buffers are single copies (plus their
+		 * tails), while the punctured parity and the interleaved systematic
+		 * LLRs are gathered.
+		 */
+		template <typename B, typename Q>
+		std::vector<turbo_load_run>
+		TurboDecoderFused<B,Q>::make_runs(const std::vector<int> &map)
+		{
+			const int min_copy = 16;
+			const int size     = (int)map.size();
+			std::vector<turbo_load_run> runs;
+
+			int i = 0;
+			while (i < size) {
+				int j = i + 1;
+				while (j < size && map[j] == map[j - 1] + 1)
+					j++;
+
+				if (j - i >= min_copy)
+					runs.push_back({i, j - i, map[i]});
+				else if (!runs.empty() && runs.back().src < 0)
+					runs.back().len += j - i;
+				else
+					runs.push_back({i, j - i, -1});
+				i = j;
+			}
+			return runs;
+		}
+
+		/*
+		 * Call of a SISO decoder of concrete type SISO (a TurboSISO), or
+		 * through the virtual interface for Decoder_SISO itself
+		 */
+		template <class SISO>
+		struct turbo_siso_call
+		{
+			template <typename R>
+			static inline void apply(module::Decoder_SISO<R> &siso,
+			                         const R *sys, const R *par, R *ext,
+			                         int n_frames)
+			{
+				static_cast<SISO&>(siso).decode_siso_static(sys, par, ext);
+			}
+		};
+
+		template <typename Q>
+		struct turbo_siso_call<module::Decoder_SISO<Q>>
+		{
+			template <typename R>
+			static inline void apply(module::Decoder_SISO<R> &siso,
+			                         const R *sys, const R *par, R *ext,
+			                         int n_frames)
+			{
+				siso.decode_siso(sys, par, ext, n_frames);
+			}
+		};
+
+		/*
+		 * One iteration of Decoder_turbo_fast::_decode, returning true if a
+		 * handler stopped the decoding (only if stoppable). The hard
+		 * decisions are taken after the last iteration or when stopping
+		 * after the interleaved domain SISO.
+		 */
+		template <typename B, typename Q>
+		template <class SISO>
+		inline bool
+		TurboDecoderFused<B,Q>::step(int ite, bool last, bool stoppable)
+		{
+			const int n_frames = this->get_simd_inter_frame_level();
+			const int K        = this->K;
+
+			/* SISO in the natural domain, on sys + ext */
+			for (int i = 0; i < K * n_frames; i += mipp::nElReg<Q>())
+				(mipp::Reg<Q>(&this->l_sn[i]) +
+				 mipp::Reg<Q>(&this->l_e1n[i])).store(&this->l_sen[i]);
+			std::copy(this->l_sn.begin() +  K               * n_frames,
+			          this->l_sn.begin() + (K + d_tail_n_2) * n_frames,
+			          this->l_sen.begin() + K               * n_frames);
+
+			turbo_siso_call<SISO>::apply(this->siso_n, this->l_sen.data(),
+			                             this->l_pn.data(),
+			                             this->l_e2n.data(), n_frames);
+			for (auto &cb : this->callbacks_siso_n)
+				if (cb(ite, this->l_sen, this->l_e2n, this->s) && stoppable)
+					return true;
+
+			/* SISO in the interleaved domain */
+			this->pi.interleave(this->l_e2n.data(), this->l_e1i.data(), 0,
+			                    n_frames, n_frames > 1);
+			for (int i = 0; i < K * n_frames; i += mipp::nElReg<Q>())
+				(mipp::Reg<Q>(&this->l_si[i]) +
+				 mipp::Reg<Q>(&this->l_e1i[i])).store(&this->l_sei[i]);
+			std::copy(this->l_si.begin() +  K               * n_frames,
+			          this->l_si.begin() + (K + d_tail_i_2) * n_frames,
+			          this->l_sei.begin() + K               * n_frames);
+
+			turbo_siso_call<SISO>::apply(this->siso_i, this->l_sei.data(),
+			                             this->l_pi.data(),
+			                             this->l_e2i.data(), n_frames);
+			bool stop = false;
+			for (auto &cb : this->callbacks_siso_i)
+				if ((stop = cb(ite, this->l_sei, this->l_e2i) && stoppable))
+					break;
+
+			/* A posteriori LLRs for the hard decisions */
+			if (stop || last)
+				for (int i = 0; i < K * n_frames; i += mipp::nElReg<Q>())
+					(mipp::Reg<Q>(&this->l_e2i[i]) +
+					 mipp::Reg<Q>(&this->l_sei[i])).store(&this->l_e2i[i]);
+
+			this->pi.deinterleave(this->l_e2i.data(), this->l_e1n.data(), 0,
+			                      n_frames, n_frames > 1);
+
+			if (stop || last)
+				hard_decision();
+			return stop;
+		}
+
+		template <typename B, typename Q>
+		template <class SISO>
+		void
+		TurboDecoderFused<B,Q>::decode_static()
+		{
+			int ite = 1;
+			while (!step<SISO>(ite, ite == this->n_ite, true) && ite < this->n_ite)
+				ite++;
+
+			for (auto &cb : this->callbacks_end)
+				cb(ite);
+		}
+
+		/*
+		 * Single iteration on all lanes (lane-by-lane decoding), without
+		 * hard decisions. The handlers can't stop the iteration.
+		 */
+		template <typename B, typename Q>
+		template <class SISO>
+		void
+		TurboDecoderFused<B,Q>::iterate_static(int ite)
+		{
+			step<SISO>(ite, false, false);
+		}
+
+		/* Same as Decoder_NO: s[i] = l_e1n[i] < 0 */
+		template <typename B, typename Q>
+		void
+		TurboDecoderFused<B,Q>::hard_decision()
+		{
+			const int size     = this->K * this->get_simd_inter_frame_level();
+			const int vec_size = (size / mipp::nElReg<Q>()) * mipp::nElReg<Q>();
+			const Q *post      = this->l_e1n.data();
+			B *s               = this->s.data();
+
+			for (int i = 0; i < vec_size; i += mipp::nElReg<Q>())
+				(mipp::cast<Q,B>(mipp::Reg<Q>(&post[i])) >>
+				 (sizeof(B) * 8 - 1)).store(&s[i]);
+			for (int i = vec_size; i < size; i++)
+				s[i] = post[i] < 0;
+		}
+
+		/*
+		 * Flip and quantize the N LLRs of a codeword into d_llrs, with the
+		 * same rounding (half away from zero) and saturation as
+		 * Quantizer_standard, without calling std::round
+		 */
+		template <typename B, typename Q>
+		void
+		TurboDecoderFused<B,Q>::quantize(const float *y)
+		{
+			const int N        = d_N;
+			const float factor = d_factor;
+			const float vmax   = d_val_max;
+			Q *q               = d_llrs.data();
+
+			if (d_fixed_point) {
+				for (int i = 0; i < N; i++) {
+					const float v = std::min(std::max(y[i] * factor, -vmax), vmax);
+					const int t   = (int)v; /* truncated */
+					const float r = v - (float)t;
+					q[i] = (Q)(t + (r >= 0.5f) - (r <= -0.5f));
+				}
+			} else {
+				for (int i = 0; i < N; i++)
+					q[i] = (Q)(y[i] * factor);
+			}
+		}
+
+		/*
+		 * Load one buffer of a lane of the decoder (lanes interleaved when
+		 * decoding multiple frames) from d_llrs
+		 */
+		template <typename B, typename Q>
+		void
+		TurboDecoderFused<B,Q>::load_lane_buffer(int f,
+		                                         const std::vector<int> &map,
+		                                         const std::vector<turbo_load_run> &runs,
+		                                         Q *out) const
+		{
+			const int n_frames = this->get_simd_inter_frame_level();
+			const int *m       = map.data();
+			const Q *q         = d_llrs.data();
+			Q *o               = out + f;
+
+			for (const turbo_load_run &r : runs) {
+				if (r.src >= 0 && n_frames == 1) {
+					std::copy(q + r.src, q + r.src + r.len, o + r.dst);
+				} else if (r.src >= 0) {
+					for (int i = 0; i < r.len; i++)
+						o[(r.dst + i) * n_frames] = q[r.src + i];
+				} else {
+					for (int i = r.dst; i < r.dst + r.len; i++)
+						o[i * n_frames] = q[m[i]];
+				}
+			}
+		}
+
+		/*
+		 * Load the four buffers of lane f. A NULL codeword is zero-filled
+		 * (erasure).
+		 */
+		template <typename B, typename Q>
+		void
+		TurboDecoderFused<B,Q>::load_lane_buffers(const float *y, int f)
+		{
+			if (y)
+				quantize(y);
+			else
+				std::fill(d_llrs.begin(), d_llrs.begin() + d_N, (Q)0);
+
+			load_lane_buffer(f, d_map_sn, d_runs_sn, this->l_sn.data());
+			load_lane_buffer(f, d_map_pn, d_runs_pn, this->l_pn.data());
+			load_lane_buffer(f, d_map_si, d_runs_si, this->l_si.data());
+			load_lane_buffer(f, d_map_pi, d_runs_pi, this->l_pi.data());
+		}
+
+		/* Missing codewords of a partial batch are zero-filled (erasures),
+		 * such that all lanes hold valid data */
+		template <typename B, typename Q>
+		void
+		TurboDecoderFused<B,Q>::decode_llrs(const float *in, int n_codewords)
+		{
+			const int n_frames = this->get_simd_inter_frame_level();
+
+			for (int f = 0; f < n_frames; f++)
+				load_lane_buffers((f < n_codewords) ? in + f * d_N : NULL, f);
+			std::fill(this->l_e1n.begin(), this->l_e1n.end(), (Q)0);
+
+			(this->*d_decode)();
+		}
+
+		template <typename B, typename Q>
+		void
+		TurboDecoderFused<B,Q>::store_bytes(unsigned char *out,
+		                                    int n_codewords,
+		                                    bool packed) const
+		{
+			const int n_frames = this->get_simd_inter_frame_level();
+			const int K        = this->K;
+			const B *s         = this->s.data();
+
+			if (n_frames == 1) {
+				if (packed)
+					turbo_pack_bits(s, out, K / 8);
+				else
+					for (int i = 0; i < K; i++)
+						out[i] = (unsigned char)s[i];
+				return;
+			}
+
+			/* Inter-frame: bit i of lane f is at s[i * n_frames + f] */
+			for (int f = 0; f < n_codewords; f++) {
+				if (packed) {
+					unsigned char *o = out + f * (K / 8);
+					for (int j = 0; j < K / 8; j++) {
+						unsigned char byte = 0;
+						for (int k = 0; k < 8; k++)
+							byte |= (s[(8 * j + k) * n_frames + f] != 0) << (7 - k);
+						o[j] = byte;
+					}
+				} else {
+					unsigned char *o = out + f * K;
+					for (int i = 0; i < K; i++)
+						o[i] = (unsigned char)s[i * n_frames + f];
+				}
+			}
+		}
+
+		template <typename B, typename Q>
+		void
+		TurboDecoderFused<B,Q>::load_lane(const float *in, int f)
+		{
+			const int n_frames = this->get_simd_inter_frame_level();
+
+			load_lane_buffers(in, f);
+			for (int i = 0; i < this->K; i++)
+				this->l_e1n[i * n_frames + f] = (Q)0;
+		}
+
+		template <typename B, typename Q>
+		void
+		TurboDecoderFused<B,Q>::iterate(int ite)
+		{
+			(this->*d_iterate)(ite);
+		}
+
+		/*
+		 * The a posteriori LLRs in the natural domain are the systematic
+		 * LLRs plus the extrinsic LLRs of both SISOs, l_e1n holding those of
+		 * the interleaved domain SISO once deinterleaved.
+		 */
+		template <typename B, typename Q>
+		void
+		TurboDecoderFused<B,Q>::lane_hard_decision(int f, B *bits) const
+		{
+			const int n_frames = this->get_simd_inter_frame_level();
+
+			for (int i = 0; i < this->K; i++) {
+				const int j = i * n_frames + f;
+				bits[i] = ((float)this->l_sn[j] + (float)this->l_e2n[j] +
+				           (float)this->l_e1n[j]) < 0.0f;
+			}
+		}
+
+		/*
+		 * Trellis of the RSC code with feedback polynomial poly_fb and
+		 * feedforward polynomial poly_ff (8 states), as generated by
+		 * Encoder_RSC_generic_sys and laid out by get_trellis: rows 0-2
+		 * and 3-5 hold the two transitions into each state (initial state,
+		 * gamma coefficient and gamma), rows 6-7 and 8-9 the transition out
+		 * of each state for a systematic bit of 0 and 1 (final state and
+		 * gamma).
+		 */
+		struct turbo_trellis_table {
+			int t[10][8];
+		};
+
+		static constexpr turbo_trellis_table
+		turbo_make_trellis(int poly_fb, int poly_ff)
+		{
+			const int n_ff = 3;
+			turbo_trellis_table tr = {};
+			bool occurrence[8] = {};
+
+			for (int i = 0; i < 8; i++) {
+				int tail = 0, parity = 0;
+				for (int b = 0; b < n_ff; b++) {
+					tail   ^= ((i >> b) & 1) & ((poly_fb >> b) & 1);
+					parity ^= ((i >> b) & 1) & ((poly_ff >> b) & 1);
+				}
+
+				for (int bit_sys = 0; bit_sys < 2; bit_sys++) {
+					const int fb    = bit_sys ? 1 - tail : tail;
+					const int gamma = bit_sys ^ fb ^ parity;
+					const int state = (i >> 1) ^ (fb << (n_ff - 1));
+					const int row   = occurrence[state] ? 3 : 0;
+
+					tr.t[row + 0][state]     = i;
+					tr.t[row + 1][state]     = bit_sys ? -1 : +1;
+					tr.t[row + 2][state]     = gamma;
+					tr.t[6 + 2 * bit_sys][i] = state;
+					tr.t[7 + 2 * bit_sys][i] = gamma;
+					occurrence[state] = true;
+				}
+			}
+			return tr;
+		}
+
+		/*
+		 * Trellis of the LTE constituent code {013, 015}, generated at
+		 * compile time and shared by all codecs. The BCJR decoders keep a
+		 * reference to it.
+		 */
+		static const std::vector<std::vector<int>> &
+		turbo_trellis()
+		{
+			static constexpr turbo_trellis_table table = turbo_make_trellis(013, 015);
+			static const std::vector<std::vector<int>> trellis = []()
+			{
+				std::vector<std::vector<int>> t;
+				for (const auto &row : table.t)
+					t.emplace_back(row, row + 8);
+				return t;
+			}();
+			return trellis;
+		}
+
+		template <typename B, typename Q, typename QD>
+		TurboCodecImpl<B,Q,QD>::TurboCodecImpl(int K, bool pct_en, int n_ite,
+		                                       bool flip_llrs,
+		                                       bool inter_frame,
+		                                       const std::string &crc_poly,
+		                                       int window_len,
+		                                       int training_len,
+		                                       int n_sub_blocks,
+		                                       bool radix4,
+		                                       bool pack_bits,
+		                                       const std::string &max_op,
+		                                       float ext_scale, bool hd_stop)
+			: crc(NULL),
+			  d_pack_bits(pack_bits),
+			  d_hd_stop(hd_stop),
+			  d_lanes(inter_frame && (hd_stop || !crc_poly.empty())),
+			  d_converged(false)
+		{
+			/* Parameters */
+			const int poly[2] = {013, 015};
+			std::vector<std::vector<bool>> pct_pattern = {{1,1},{1,0},{0,1}};
+			bool buff_enc = true;
+			/* In inter-frame mode, each SIMD lane decodes its own codeword */
+			int n_frames  = (inter_frame) ? mipp::nElReg<Q>() : 1;
+
+			/* Derived constants */
+			int tail_length_rsc = (int)(2 * std::floor(std::log2((float)std::max(poly[0], poly[1]))));
+			int tail_length_enc = 2 * tail_length_rsc;
+			int N_cw_turbo  = (3 * K) + tail_length_enc;
+			int N           = (pct_en) ? (((K/2) * 4) + (tail_length_enc)) : N_cw_turbo;
+
+			/* Internal configs and buffers */
+			d_K             = K;
+			d_N             = N;
+			d_n_frames      = n_frames;
+			d_n_valid       = n_frames;
+			d_stats.ite_hist.assign(n_ite + 1, 0);
+			d_stats.n_failures  = 0;
+			d_stats.time_sum_ns = 0;
+			d_stats.time_max_ns = 0;
+			d_out_len       = (pack_bits) ? K / 8 : K;
+
+			/* Modules */
+			interleaver = new module::Interleaver_LTE<int> (K);
+			interleaver->init();
+
+			const std::vector<std::vector<int>> &trellis = turbo_trellis();
+
+#ifdef DEBUG_DEC
+			printf("Treliss: ");
+			for(int i =0; i<8; i++)
+				printf("%d ", trellis[0][i]);
+			printf("\n");
+#endif
+
+			/* The max operator is a template parameter of the SISOs */
+			make_sisos(max_op, K, trellis, inter_frame, window_len,
+			           training_len, n_sub_blocks, radix4,
+			           std::integral_constant<bool, !turbo_codec_qnt<Q>::fixed_point>());
+
+			/* The depuncturer only describes the layout of the input stream,
+			 * the decoder depunctures the LLRs while loading them */
+			module::Puncturer_turbo<B_32,Q_32> *pct = NULL;
+			if (pct_en)
+				pct = new module::Puncturer_turbo<B_32,Q_32>(K, N,
+				                                             tail_length_enc,
+				                                             pct_pattern,
+				                                             buff_enc);
+
+			dec = new TurboDecoderFused<B,Q>(K, N_cw_turbo, n_ite, *interleaver,
+			                                 *sub_dec, *sub_dec_i, N, pct,
+			                                 flip_llrs,
+			                                 turbo_codec_qnt<Q>::fixed_point_pos,
+			                                 turbo_codec_qnt<Q>::saturation_pos);
+			d_compose(*dec);
+			delete pct;
+
+			if (d_siso_reset) {
+				dec->add_handler_end([this](const int n_ite_used)
+				{
+					d_siso_reset();
+				});
+			}
+
+			/* Scale the extrinsic LLRs after each SISO decoding */
+			if (ext_scale != 1.0f) {
+				dec->add_handler_siso_n([ext_scale](const int ite,
+				                                    const mipp::vector<Q> &sys,
+				                                    mipp::vector<Q> &ext,
+				                                    mipp::vector<B> &s)
+				{
+					turbo_codec_scale<Q>(ext, ext_scale);
+					return false;
+				});
+				dec->add_handler_siso_i([ext_scale](const int ite,
+				                                    const mipp::vector<Q> &sys,
+				                                    mipp::vector<Q> &ext)
+				{
+					turbo_codec_scale<Q>(ext, ext_scale);
+					return false;
+				});
+			}
+
+			if (turbo_codec_qnt<Q>::fixed_point) {
+				/* Saturate the extrinsic LLRs after each SISO decoding */
+				const Q ext_sat = turbo_codec_qnt<Q>::ext_sat;
+				dec->add_handler_siso_n([ext_sat](const int ite,
+				                                  const mipp::vector<Q> &sys,
+				                                  mipp::vector<Q> &ext,
+				                                  mipp::vector<B> &s)
+				{
+					tools::saturate<Q>(ext, -ext_sat, ext_sat);
+					return false;
+				});
+				dec->add_handler_siso_i([ext_sat](const int ite,
+				                                  const mipp::vector<Q> &sys,
+				                                  mipp::vector<Q> &ext)
+				{
+					tools::saturate<Q>(ext, -ext_sat, ext_sat);
+					return false;
+				});
+			}
+
+			/* CRC-aided early termination. Registered after the saturation
+			 * handlers, such that the CRC is checked on saturated LLRs. */
+			if (!crc_poly.empty()) {
+				int crc_size = module::CRC_polynomial<B>::get_size(crc_poly);
+				if (crc_size >= K)
+					throw std::runtime_error("turbo_decoder: CRC does not fit "
+					                         "in the dataword");
+
+				crc = new module::CRC_polynomial<B>(K - crc_size, crc_poly);
+			}
+
+			/* Per-lane decoding checks the criteria itself, after each
+			 * iteration */
+			if (d_lanes) {
+				d_lane_bits.resize(K);
+				d_hd_prev.resize(K * n_frames);
+			}
+
+			if (crc && !d_lanes) {
+				d_post.resize(K * n_frames);
+				d_post_n.resize(K * n_frames);
+				d_crc_bits.resize(K);
+
+				/* Natural domain: if the CRC passes, the hard decision is
+				 * left to this handler */
+				dec->add_handler_siso_n([this](const int ite,
+				                               const mipp::vector<Q> &sys,
+				                               mipp::vector<Q> &ext,
+				                               mipp::vector<B> &s)
+				{
+					const int size = d_K * d_n_frames;
+					for (int i = 0; i < size; i++)
+						d_post[i] = sys[i] + ext[i];
+
+					if (!crc_check(d_post.data()))
+						return false;
+
+					for (int i = 0; i < size; i++)
+						s[i] = d_post[i] < 0;
+					d_converged = true;
+					return true;
+				});
+
+				/* Interleaved domain: the decoder computes the hard decision
+				 * itself when stopping after this SISO */
+				dec->add_handler_siso_i([this](const int ite,
+				                               const mipp::vector<Q> &sys,
+				                               mipp::vector<Q> &ext)
+				{
+					const int size = d_K * d_n_frames;
+					for (int i = 0; i < size; i++)
+						d_post[i] = sys[i] + ext[i];
+
+					interleaver->deinterleave(d_post.data(), d_post_n.data(), 0,
+					                          d_n_frames, d_n_frames > 1);
+					d_converged = crc_check(d_post_n.data());
+					return d_converged;
+				});
+			}
+
+			/* Hard-decision stability, checked on the a posteriori LLRs of
+			 * the interleaved domain (the permutation doesn't change from
+			 * one iteration to the next) */
+			if (hd_stop && !d_lanes) {
+				d_hd_prev.resize(K * n_frames);
+				dec->add_handler_siso_i([this](const int ite,
+				                               const mipp::vector<Q> &sys,
+				                               mipp::vector<Q> &ext)
+				{
+					const int size = d_K * d_n_frames;
+					bool stable    = (ite > 1);
+					for (int i = 0; i < size; i++) {
+						const B hd = ((float)sys[i] + (float)ext[i]) < 0;
+						stable = stable && (hd == d_hd_prev[i]);
+						d_hd_prev[i] = hd;
+					}
+					/* With a CRC, only the CRC tells a valid codeword */
+					if (!crc)
+						d_converged = stable;
+					return stable;
+				});
+			}
+
+			/* Iterations used by each (non-padding) codeword of the batch
+			 * (not called when decoding lane by lane) */
+			dec->add_handler_end([this](const int n_ite_used)
+			{
+				d_stats.ite_hist[n_ite_used] += d_n_valid;
+				if ((crc || d_hd_stop) && !d_converged)
+					d_stats.n_failures += d_n_valid;
+			});
+		}
+
+		/* Compose the decoding loop of dec with SISO decoders of type SISO */
+		template <typename B, typename Q, class SISO>
+		static void
+		turbo_compose(TurboDecoderFused<B,Q> &dec)
+		{
+			dec.template compose<SISO>();
+		}
+
+		/*
+		 * Instantiate the SISO decoders (natural and interleaved domains)
+		 * with the given max operators: MAX1/MAX2 for the sequential BCJRs
+		 * and MAX_i for the inter-frame BCJR.
+		 */
+		template <typename B, typename Q, typename QD>
+		template <tools::proto_max<Q> MAX1, tools::proto_max<QD> MAX2,
+		          tools::proto_max_i<Q> MAX_i>
+		void
+		TurboCodecImpl<B,Q,QD>::make_sisos(int K,
+		                                   const std::vector<std::vector<int>> &trellis,
+		                                   bool inter_frame, int window_len,
+		                                   int training_len, int n_sub_blocks,
+		                                   bool radix4)
+		{
+			typedef TurboSISO<module::Decoder_RSC_BCJR_inter_very_fast <B,Q,MAX_i>> SISO_inter;
+			typedef TurboSISO<module::Decoder_RSC_BCJR_seq_sliding_window <B,Q,QD,MAX1,MAX2>> SISO_window;
+			typedef TurboSISO<module::Decoder_RSC_BCJR_seq_sub_block <B,Q,QD,MAX1,MAX2>> SISO_sub_block;
+			typedef TurboSISO<module::Decoder_RSC_BCJR_seq_radix4 <B,Q,QD,MAX1,MAX2>> SISO_radix4;
+			typedef TurboSISO<module::Decoder_RSC_BCJR_seq_very_fast <B,Q,QD,MAX1,MAX2>> SISO_very_fast;
+			const bool buff_enc = true;
+
+			sub_dec_i = NULL;
+			if (inter_frame) {
+				sub_dec   = new SISO_inter (K, trellis, buff_enc, d_n_frames);
+				d_compose = turbo_compose<B,Q,SISO_inter>;
+			} else if (window_len > 0) {
+				sub_dec   = new SISO_window (K, trellis, window_len, training_len);
+				d_compose = turbo_compose<B,Q,SISO_window>;
+			} else if (n_sub_blocks > 1) {
+				/* The sub-block SISOs keep boundary metrics from one
+				 * iteration to the next, hence one per domain. Each
+				 * codeword starts with equiprobable boundary metrics. */
+				SISO_sub_block *sb_n = new SISO_sub_block (K, trellis, n_sub_blocks);
+				SISO_sub_block *sb_i = new SISO_sub_block (K, trellis, n_sub_blocks);
+				sub_dec   = sb_n;
+				sub_dec_i = sb_i;
+				d_siso_reset = [sb_n, sb_i]()
+				{
+					sb_n->reset();
+					sb_i->reset();
+				};
+				d_compose = turbo_compose<B,Q,SISO_sub_block>;
+			} else if (radix4) {
+				sub_dec   = new SISO_radix4 (K, trellis);
+				d_compose = turbo_compose<B,Q,SISO_radix4>;
+			} else {
+				sub_dec   = new SISO_very_fast (K, trellis);
+				d_compose = turbo_compose<B,Q,SISO_very_fast>;
+			}
+
+			if (!sub_dec_i)
+				sub_dec_i = sub_dec;
+		}
+
+		/* Floating-point LLRs: all the max operators. The scalar log-MAP
+		 * correction skips the exp/log1p evaluations where negligible. */
+		template <typename B, typename Q, typename QD>
+		void
+		TurboCodecImpl<B,Q,QD>::make_sisos(const std::string &max_op, int K,
+		                                   const std::vector<std::vector<int>> &trellis,
+		                                   bool inter_frame, int window_len,
+		                                   int training_len, int n_sub_blocks,
+		                                   bool radix4, std::true_type)
+		{
+			if (max_op == "max_star")
+				make_sisos<tools::max_star_safe<Q>, tools::max_star_safe<QD>,
+				           tools::max_star_i<Q>>(K, trellis, inter_frame,
+				                                 window_len, training_len,
+				                                 n_sub_blocks, radix4);
+			else if (max_op == "max_linear")
+				make_sisos<tools::max_linear<Q>, tools::max_linear<QD>,
+				           tools::max_linear_i<Q>>(K, trellis, inter_frame,
+				                                   window_len, training_len,
+				                                   n_sub_blocks, radix4);
+			else
+				make_sisos<tools::max<Q>, tools::max<QD>,
+				           tools::max_i<Q>>(K, trellis, inter_frame,
+				                            window_len, training_len,
+				                            n_sub_blocks, radix4);
+		}
+
+		/* Fixed-point LLRs: the max* corrections are only defined on real
+		 * numbers, hence max-log-MAP only (checked by TurboCodec::make) */
+		template <typename B, typename Q, typename QD>
+		void
+		TurboCodecImpl<B,Q,QD>::make_sisos(const std::string &max_op, int K,
+		                                   const std::vector<std::vector<int>> &trellis,
+		                                   bool inter_frame, int window_len,
+		                                   int training_len, int n_sub_blocks,
+		                                   bool radix4, std::false_type)
+		{
+			make_sisos<tools::max<Q>, tools::max<QD>,
+			           tools::max_i<Q>>(K, trellis, inter_frame, window_len,
+			                            training_len, n_sub_blocks, radix4);
+		}
+
+		template <typename B, typename Q, typename QD>
+		TurboCodecImpl<B,Q,QD>::~TurboCodecImpl()
+		{
+			delete interleaver;
+			if (sub_dec_i != sub_dec)
+				delete sub_dec_i;
+			delete sub_dec;
+			delete dec;
+			delete crc;
+		}
+
+		/*
+		 * Check the CRC of the hard decisions taken on the a posteriori LLRs
+		 * of each codeword in the batch (natural domain, with the lanes
+		 * interleaved when decoding multiple frames). Padding lanes of a
+		 * partial batch are ignored.
+		 */
+		template <typename B, typename Q, typename QD>
+		bool
+		TurboCodecImpl<B,Q,QD>::crc_check(const Q *post)
+		{
+			for (int f = 0; f < d_n_valid; f++) {
+				for (int i = 0; i < d_K; i++)
+					d_crc_bits[i] = post[i * d_n_frames + f] < 0;
+
+				if (!crc->check(d_crc_bits.data()))
+					return false;
+			}
+			return true;
+		}
+
+		template <typename B, typename Q, typename QD>
+		void
+		TurboCodecImpl<B,Q,QD>::decode(const float *in, unsigned char *out,
+		                               int n_codewords, unsigned char *failed)
+		{
+			/* Decode full batches of d_n_frames codewords. The last batch may
+			 * be partial, in which case it is flushed right away (zero-padded)
+			 * rather than waiting for more input. */
+			if (d_lanes) {
+				decode_lanes(in, out, n_codewords, failed);
+				return;
+			}
+
+			for (int i = 0; i < n_codewords; i += d_n_frames) {
+				int n_batch = std::min(d_n_frames, n_codewords - i);
+				decode_batch(in + (i * d_N), out + (i * d_out_len), n_batch,
+				             failed ? failed + i : NULL);
+			}
+		}
+
+		/*
+		 * Decode the codewords lane by lane: each lane holds its own
+		 * codeword and iteration count. After each iteration, the lanes
+		 * whose codeword passes the CRC, has stable hard decisions or used
+		 * all iterations are stored and refilled with the next codeword, so
+		 * that a slow codeword doesn't hold the whole batch back. Lanes left
+		 * without a codeword decode erasures until the others are done.
+		 */
+		template <typename B, typename Q, typename QD>
+		void
+		TurboCodecImpl<B,Q,QD>::decode_lanes(const float *in,
+		                                     unsigned char *out,
+		                                     int n_codewords,
+		                                     unsigned char *failed)
+		{
+			const int n_ite = (int)d_stats.ite_hist.size() - 1;
+			std::vector<int> lane_cw(d_n_frames, -1); /* -1 if idle */
+			std::vector<int> lane_ite(d_n_frames, 0);
+			std::vector<turbo_clock::time_point> lane_t0(d_n_frames);
+			int next_cw  = 0;
+			int n_active = 0;
+
+			for (int f = 0; f < d_n_frames; f++) {
+				if (next_cw < n_codewords) {
+					lane_cw[f] = next_cw++;
+					n_active++;
+				}
+				dec->load_lane((lane_cw[f] < 0) ? NULL : in + lane_cw[f] * d_N,
+				               f);
+				lane_t0[f] = turbo_clock::now();
+			}
+
+			for (int ite = 1; n_active > 0; ite++) {
+				dec->iterate(ite);
+
+				for (int f = 0; f < d_n_frames; f++) {
+					if (lane_cw[f] < 0)
+						continue;
+
+					B *bits = d_lane_bits.data();
+					B *prev = d_hd_prev.data() + f * d_K;
+					dec->lane_hard_decision(f, bits);
+					lane_ite[f]++;
+
+					const bool crc_ok = crc && crc->check(bits);
+					bool stable = false;
+					if (d_hd_stop) {
+						stable = (lane_ite[f] > 1 &&
+						          std::equal(bits, bits + d_K, prev));
+						std::copy(bits, bits + d_K, prev);
+					}
+					if (!crc_ok && !stable && lane_ite[f] < n_ite)
+						continue;
+
+					unsigned char *o = out + lane_cw[f] * d_out_len;
+					if (d_pack_bits)
+						turbo_pack_bits(bits, o, d_K / 8);
+					else
+						std::copy(bits, bits + d_K, o);
+					const bool fail = crc ? !crc_ok : !stable;
+					d_stats.ite_hist[lane_ite[f]]++;
+					d_stats.n_failures += fail;
+					if (failed)
+						failed[lane_cw[f]] = fail;
+					add_decode_time(turbo_elapsed_ns(lane_t0[f]), 1);
+
+					/* Refill the lane */
+					lane_ite[f] = 0;
+					if (next_cw < n_codewords) {
+						lane_cw[f] = next_cw++;
+					} else {
+						lane_cw[f] = -1;
+						n_active--;
+					}
+					dec->load_lane((lane_cw[f] < 0) ? NULL : in + lane_cw[f] * d_N,
+					               f);
+					lane_t0[f] = turbo_clock::now();
+				}
+			}
+		}
+
+		/*
+		 * Decode a batch of up to d_n_frames contiguous codewords
+		 */
+		template <typename B, typename Q, typename QD>
+		void
+		TurboCodecImpl<B,Q,QD>::decode_batch(const float *in,
+		                                     unsigned char *out,
+		                                     int n_codewords,
+		                                     unsigned char *failed)
+		{
+			const turbo_clock::time_point t0 = turbo_clock::now();
+
+			d_n_valid   = n_codewords;
+			d_converged = false;
+			dec->decode_llrs(in, n_codewords);
+			dec->store_bytes(out, n_codewords, d_pack_bits);
+			add_decode_time(turbo_elapsed_ns(t0), n_codewords);
+
+			if (failed)
+				std::fill(failed, failed + n_codewords,
+				          (crc || d_hd_stop) && !d_converged);
+
+#ifdef DEBUG_DEC
+			printf("dec_in = ");
+			for(int j = 0; j < n_codewords * d_N; j++)
+				printf("%f ", in[j]);
+			printf("\n");
+
+			printf("dec_out = ");
+			for(int j = 0; j < n_codewords * d_out_len; j++)
+				printf("%d ", out[j]);
+			printf("\n");
+#endif
+		}
+
+		template class TurboDecoderFused<B_32,Q_32>;
+		template class TurboDecoderFused<B_16,Q_16>;
+
+		template class TurboCodecImpl<B_32,Q_32,QD_32>;
+		template class TurboCodecImpl<B_16,Q_16,QD_16>;
+
+	} /* namespace TURBO_CODEC_ISA */
+	} /* namespace blocksat */
+} /* namespace gr */
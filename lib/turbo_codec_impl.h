@@ -0,0 +1,292 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2019 Blockstream Corp.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_BLOCKSAT_TURBO_CODEC_IMPL_H
+#define INCLUDED_BLOCKSAT_TURBO_CODEC_IMPL_H
+
+#include "turbo_codec.h"
+#include "Tools/types.h"
+#include "Module/Interleaver/LTE/Interleaver_LTE.hpp"
+
+#include "Module/Decoder/Turbo/Decoder_turbo.hpp"
+#include "Module/Decoder/RSC/BCJR/Seq/Decoder_RSC_BCJR_seq_very_fast.hpp"
+#include "Module/Decoder/RSC/BCJR/Seq/Decoder_RSC_BCJR_seq_sliding_window.hpp"
+#include "Module/Decoder/RSC/BCJR/Seq/Decoder_RSC_BCJR_seq_sub_block.hpp"
+#include "Module/Decoder/RSC/BCJR/Seq/Decoder_RSC_BCJR_seq_radix4.hpp"
+#include "Module/Decoder/RSC/BCJR/Inter/Decoder_RSC_BCJR_inter_very_fast.hpp"
+#include "Module/Decoder/Turbo/Decoder_turbo_fast.hpp"
+#include "Module/Puncturer/Turbo/Puncturer_turbo.hpp"
+#include "Module/CRC/Polynomial/CRC_polynomial.hpp"
+#include <functional>
+#include <type_traits>
+
+/*
+ * The kernels below are built once per SIMD level (see lib/CMakeLists.txt),
+ * each within its own TURBO_CODEC_ISA namespace and with the aff3ct and mipp
+ * namespaces renamed accordingly, such that the instantiations of distinct
+ * levels don't collide.
+ */
+#ifndef TURBO_CODEC_ISA
+#define TURBO_CODEC_ISA generic
+#endif
+
+using namespace aff3ct;
+
+namespace gr {
+	namespace blocksat {
+	namespace TURBO_CODEC_ISA {
+
+		/*
+		 * \brief Construct the codec of this SIMD level
+		 *
+		 * Same parameters as TurboCodec::make, which validates them.
+		 * Returns NULL if the precision is not implemented at this level.
+		 */
+		TurboCodec *make_codec(int K, bool pct_en, int n_ite, bool flip_llrs,
+		                       bool inter_frame, int precision,
+		                       const std::string &crc, int window_len,
+		                       int training_len, int n_sub_blocks,
+		                       bool radix4, bool pack_bits,
+		                       const std::string &max_op, float ext_scale,
+		                       bool hd_stop);
+
+		/*
+		 * \brief LLRs per SIMD register of the codec of the given precision
+		 *        at this level (0 if the precision is not implemented)
+		 */
+		int simd_lanes(int precision);
+
+		/*
+		 * SISO decoder of concrete type SISO, whose kernel the decoding loop
+		 * calls directly (and can inline) rather than through the virtual
+		 * Decoder_SISO interface. Each lane holds a single wave of frames,
+		 * hence frame_id 0.
+		 */
+		template <class SISO>
+		class TurboSISO final : public SISO
+		{
+		public:
+			using SISO::SISO;
+
+			template <typename R>
+			inline void decode_siso_static(const R *sys, const R *par, R *ext)
+			{
+				SISO::_decode_siso(sys, par, ext, 0);
+			}
+		};
+
+		/*
+		 * Run of a decoder buffer: len positions from dst on read the
+		 * quantized LLRs from src on (contiguous copy), or follow the index
+		 * map if src < 0
+		 */
+		struct turbo_load_run {
+			int dst;
+			int len;
+			int src;
+		};
+
+		/*
+		 * Turbo decoder fed straight from the received LLR stream. Each
+		 * codeword is flipped and quantized in a single vectorizable pass,
+		 * then depunctured and reordered into the systematic and parity
+		 * buffers of both domains, following precomputed maps from each
+		 * buffer position to the input LLR it comes from. The punctured
+		 * positions read a zero LLR appended to the codeword, and the
+		 * contiguous stretches of the maps are plain copies.
+		 */
+		template <typename B, typename Q>
+		class TurboDecoderFused : public module::Decoder_turbo_fast<B,Q>
+		{
+		private:
+			int d_N; /* input LLRs per codeword */
+			std::vector<int> d_map_sn; /* input index (N if punctured) */
+			std::vector<int> d_map_pn;
+			std::vector<int> d_map_si;
+			std::vector<int> d_map_pi;
+			std::vector<turbo_load_run> d_runs_sn; /* same maps, as runs */
+			std::vector<turbo_load_run> d_runs_pn;
+			std::vector<turbo_load_run> d_runs_si;
+			std::vector<turbo_load_run> d_runs_pi;
+			mipp::vector<Q> d_llrs; /* quantized codeword, then a zero LLR */
+			float d_factor; /* sign flip and fixed-point scaling */
+			float d_val_max;
+			bool d_fixed_point;
+			int d_tail_n_2; /* tail LLRs per buffer of each SISO */
+			int d_tail_i_2;
+
+			/* Decoding loop and single iteration, composed for the
+			 * concrete SISO type (see compose) */
+			void (TurboDecoderFused::*d_decode)();
+			void (TurboDecoderFused::*d_iterate)(int ite);
+
+			template <class SISO> bool step(int ite, bool last, bool stoppable);
+			template <class SISO> void decode_static();
+			template <class SISO> void iterate_static(int ite);
+			void hard_decision();
+			static std::vector<turbo_load_run> make_runs(const std::vector<int> &map);
+			void quantize(const float *y);
+			void load_lane_buffer(int f, const std::vector<int> &map,
+			                      const std::vector<turbo_load_run> &runs,
+			                      Q *out) const;
+			void load_lane_buffers(const float *y, int f);
+
+		public:
+			/*
+			 * \param N input LLRs per codeword
+			 * \param pct Puncturer of the input stream (NULL if unpunctured)
+			 * \param flip_llrs Invert the sign of the input LLRs
+			 * \param fixed_point_pos Fractional bits of fixed-point LLRs
+			 * \param saturation_pos Total bits of fixed-point LLRs (0 for
+			 *        floating-point LLRs)
+			 */
+			TurboDecoderFused(int K, int N_cw, int n_ite,
+			                  const module::Interleaver<int> &pi,
+			                  module::Decoder_SISO<Q> &siso_n,
+			                  module::Decoder_SISO<Q> &siso_i,
+			                  int N, const module::Puncturer_turbo<B_32,Q_32> *pct,
+			                  bool flip_llrs, int fixed_point_pos,
+			                  int saturation_pos);
+
+			/*
+			 * \brief Compose the decoding loop with the concrete type of
+			 *        both SISOs (a TurboSISO), such that their kernels are
+			 *        called without virtual dispatch. Until then, the SISOs
+			 *        are called through Decoder_SISO.
+			 */
+			template <class SISO>
+			void compose()
+			{
+				d_decode  = &TurboDecoderFused::template decode_static<SISO>;
+				d_iterate = &TurboDecoderFused::template iterate_static<SISO>;
+			}
+
+			/*
+			 * \brief Decode the d_n_frames codewords of a batch
+			 * \param in Pointer to the n_codewords * N input LLRs
+			 * \param n_codewords Codewords in the batch, the missing ones are
+			 *        decoded as erasures
+			 */
+			void decode_llrs(const float *in, int n_codewords);
+
+			/*
+			 * \brief Write the decoded bits of a batch straight from the hard
+			 *        decisions, skipping the padding codewords
+			 * \param out Pointer to the n_codewords * K (or K / 8 if packed)
+			 *        output bytes
+			 * \param packed Pack 8 bits per byte, MSB first
+			 */
+			void store_bytes(unsigned char *out, int n_codewords,
+			                 bool packed) const;
+
+			/*
+			 * \brief Load a codeword into SIMD lane f, with null extrinsic
+			 *        LLRs, leaving the other lanes untouched
+			 * \param in Pointer to the N input LLRs (NULL for an erasure)
+			 */
+			void load_lane(const float *in, int f);
+
+			/*
+			 * \brief Run one iteration (both SISOs and their handlers) on
+			 *        all lanes, regardless of their convergence
+			 */
+			void iterate(int ite);
+
+			/*
+			 * \brief Hard decisions of lane f on the a posteriori LLRs of
+			 *        the last iteration
+			 * \param bits Pointer to the K output bits
+			 */
+			void lane_hard_decision(int f, B *bits) const;
+		};
+
+		/*
+		 * Turbo codec working on B bits and Q LLRs (QD inside the BCJR).
+		 * With fixed-point Q, the input LLRs are quantized while loaded into
+		 * the decoder and the extrinsic LLRs are saturated after each SISO.
+		 * With a CRC, the hard decisions are checked after each SISO and the
+		 * iterations stop as soon as all codewords of the batch pass. With
+		 * hd_stop, they also stop once the hard decisions are stable.
+		 *
+		 * In inter-frame mode with either criterion, the codewords are
+		 * instead decoded lane by lane: after each iteration, the lanes whose
+		 * codeword converged (or used all iterations) are retired and
+		 * refilled with the next pending codeword.
+		 */
+		template <typename B, typename Q, typename QD>
+		class TurboCodecImpl : public TurboCodec
+		{
+		private:
+			module::Decoder_SISO<Q> *sub_dec;   /* natural domain SISO */
+			module::Decoder_SISO<Q> *sub_dec_i; /* interleaved domain (may be sub_dec) */
+			module::Interleaver_LTE<int> *interleaver;
+			TurboDecoderFused<B,Q> *dec;
+			module::CRC<B> *crc;
+			mipp::vector<Q> d_post;   /* a posteriori LLRs (CRC check) */
+			mipp::vector<Q> d_post_n; /* same, deinterleaved */
+			std::vector<B> d_crc_bits;
+			std::vector<B> d_hd_prev;   /* hard decisions of the previous iteration */
+			std::vector<B> d_lane_bits; /* hard decisions of a lane */
+			bool d_pack_bits;
+			bool d_hd_stop;
+			bool d_lanes; /* decode lane by lane */
+			bool d_converged; /* batch passed the CRC or has stable decisions */
+			std::function<void()> d_siso_reset; /* reset SISO state between codewords */
+			std::function<void(TurboDecoderFused<B,Q>&)> d_compose; /* set by make_sisos */
+
+			template <tools::proto_max<Q> MAX1, tools::proto_max<QD> MAX2,
+			          tools::proto_max_i<Q> MAX_i>
+			void make_sisos(int K, const std::vector<std::vector<int>> &trellis,
+			                bool inter_frame, int window_len,
+			                int training_len, int n_sub_blocks, bool radix4);
+			void make_sisos(const std::string &max_op, int K,
+			                const std::vector<std::vector<int>> &trellis,
+			                bool inter_frame, int window_len,
+			                int training_len, int n_sub_blocks, bool radix4,
+			                std::true_type floating_point);
+			void make_sisos(const std::string &max_op, int K,
+			                const std::vector<std::vector<int>> &trellis,
+			                bool inter_frame, int window_len,
+			                int training_len, int n_sub_blocks, bool radix4,
+			                std::false_type floating_point);
+			void decode_batch(const float *in, unsigned char *out,
+			                  int n_codewords, unsigned char *failed);
+			void decode_lanes(const float *in, unsigned char *out,
+			                  int n_codewords, unsigned char *failed);
+			bool crc_check(const Q *post);
+
+		public:
+			TurboCodecImpl(int K, bool pct_en, int n_ite, bool flip_llrs,
+			               bool inter_frame, const std::string &crc_poly,
+			               int window_len, int training_len,
+			               int n_sub_blocks, bool radix4, bool pack_bits,
+			               const std::string &max_op, float ext_scale,
+			               bool hd_stop);
+			~TurboCodecImpl();
+
+			void decode(const float *in, unsigned char *out, int n_codewords,
+			            unsigned char *failed);
+		};
+
+	} // namespace TURBO_CODEC_ISA
+	} // namespace blocksat
+} // namespace gr
+
+#endif /* INCLUDED_BLOCKSAT_TURBO_CODEC_IMPL_H */
@@ -24,7 +24,9 @@
 
 #include <gnuradio/io_signature.h>
 #include "turbo_decoder_impl.h"
-#include <volk/volk.h>
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
 
 #undef DEBUG
 #undef DEBUG_DEC
@@ -39,91 +41,288 @@ namespace gr {
 	namespace blocksat {
 
 		turbo_decoder::sptr
-		turbo_decoder::make(int K, bool pct_en, int n_ite, bool flip_llrs)
+		turbo_decoder::make(int K, bool pct_en, int n_ite, bool flip_llrs,
+		                    bool inter_frame, int n_threads, int precision,
+		                    const std::string &crc, int window_len,
+		                    int training_len, int n_sub_blocks,
+		                    bool radix4, bool pack_bits,
+		                    const std::string &max_op, float ext_scale,
+		                    bool hd_stop)
 		{
 			return gnuradio::get_initial_sptr
-				(new turbo_decoder_impl(K, pct_en, n_ite, flip_llrs));
+				(new turbo_decoder_impl(K, pct_en, n_ite, flip_llrs,
+				                        inter_frame, n_threads, precision,
+				                        crc, window_len, training_len,
+				                        n_sub_blocks, radix4, pack_bits,
+				                        max_op, ext_scale, hd_stop));
 		}
 
 		/*
 		 * The private constructor
 		 */
 		turbo_decoder_impl::turbo_decoder_impl(int K, bool pct_en, int n_ite,
-		                                       bool flip_llrs)
+		                                       bool flip_llrs, bool inter_frame,
+		                                       int n_threads, int precision,
+		                                       const std::string &crc,
+		                                       int window_len, int training_len,
+		                                       int n_sub_blocks, bool radix4,
+		                                       bool pack_bits,
+		                                       const std::string &max_op,
+		                                       float ext_scale, bool hd_stop)
 			: gr::block("turbo_decoder",
 			            gr::io_signature::make(1, 1, sizeof(float)),
 			            gr::io_signature::make(1, 1, sizeof(unsigned char))),
-			d_pct_en(pct_en),
-			d_K(K)
-		{
-			/* Parameters */
-			std::vector<int> poly = {013, 015};
-			std::vector<std::vector<bool>> pct_pattern = {{1,1},{1,0},{0,1}};
-			bool buff_enc = true;
-			int n_frames  = 1;
-
-			/* Derived constants */
-			int tail_length_rsc = (int)(2 * std::floor(std::log2((float)std::max(poly[0], poly[1]))));
-			int tail_length_enc = 2 * tail_length_rsc;
-			int N_cw_rsc    = (2 * K) + tail_length_rsc;
-			int N_cw_turbo  = (3 * K) + tail_length_enc;
-			int N           = (pct_en) ? (((K/2) * 4) + (tail_length_enc)) : N_cw_turbo;
-
-			/* Internal configs and buffers */
-			d_N             = N;
-			d_flip_llrs     = flip_llrs;
-			d_llr_buffer    = (float*)volk_malloc(N * sizeof(float),
-			                                      volk_get_alignment());
-			d_int_buffer    = (int*)volk_malloc(K * sizeof(int),
-			                                    volk_get_alignment());
-			d_pct_buffer    = (float*)volk_malloc(N_cw_turbo * sizeof(float),
-			                                      volk_get_alignment());
-
-			/* Modules */
-			interleaver = new module::Interleaver_LTE<int> (K);
-			interleaver->init();
-
-			sub_enc = new module::Encoder_RSC_generic_sys<B_8> (K, N_cw_rsc, true, poly);
-			std::vector<std::vector<int>> trellis = sub_enc->get_trellis();
-
-#ifdef DEBUG_DEC
-			printf("Treliss: ");
-			for(int i =0; i<8; i++)
-				printf("%d ", trellis[0][i]);
-			printf("\n");
-#endif
+			d_mode(0),
+			d_msg_mode(-1),
+			d_mode_changed(false),
+			d_n_ite(n_ite),
+			d_flip_llrs(flip_llrs),
+			d_crc(crc),
+			d_pack_bits(pack_bits),
+			d_redec_n_ite(0),
+			d_redec_queue_len(0),
+			d_started(false),
+			d_ite_hist(new std::atomic<uint64_t>[n_ite + 1]),
+			d_n_codewords(0),
+			d_n_failures(0),
+			d_time_sum_ns(0),
+			d_time_max_ns(0),
+			d_n_recovered(0),
+			d_n_redec_dropped(0),
+			d_stats_period(1.0f),
+			d_last_stats(std::chrono::steady_clock::now())
+		{
+			for (int i = 0; i <= n_ite; i++)
+				d_ite_hist[i] = 0;
+			d_work_stats.ite_hist.assign(n_ite + 1, 0);
+			d_work_stats.n_failures  = 0;
+			d_work_stats.time_sum_ns = 0;
+			d_work_stats.time_max_ns = 0;
+
+			if (radix4)
+				fprintf(stderr, "turbo_decoder: the radix-4 BCJR is "
+				        "experimental and slower than radix-2\n");
+
+			/* Codecs of any mode, with the settings of the block */
+			d_make_pool = [=](int K, bool pct_en) {
+				return new TurboCodecPool(n_threads, K, pct_en, n_ite,
+				                          flip_llrs, inter_frame, precision,
+				                          crc, window_len, training_len,
+				                          n_sub_blocks, radix4, pack_bits,
+				                          max_op, ext_scale, hd_stop);
+			};
+			add_mode(K, pct_en);
+			configure_modes();
+
+			message_port_register_out(pmt::mp("stats"));
+			message_port_register_out(pmt::mp("recovered"));
+			message_port_register_in(pmt::mp("mode"));
+			set_msg_handler(
+				pmt::mp("mode"),
+				boost::bind(&turbo_decoder_impl::handle_mode, this, _1));
+		}
 
-			sub_dec = new module::Decoder_RSC_BCJR_seq_very_fast <int,float,float,tools::max<float>,tools::max<float>> (K, trellis);
+		/*
+		 * Our virtual destructor.
+		 */
+		turbo_decoder_impl::~turbo_decoder_impl()
+		{
+			drop_modes(0);
+		}
 
-			dec = new module::Decoder_turbo_fast<int, float>(K, N_cw_turbo, n_ite, *interleaver, *sub_dec, *sub_dec);
+		/*
+		 * Build the decoding modules of a mode upfront, such that switching
+		 * to it is free. Modes already built are not duplicated.
+		 */
+		void
+		turbo_decoder_impl::add_mode(int K, bool pct_en)
+		{
+			for (auto &mode : d_modes) {
+				if (mode.K == K && mode.pct_en == pct_en)
+					return;
+			}
 
-			if (pct_en) {
-				pct = new module::Puncturer_turbo<int,float>(K, N,
-				                                             tail_length_enc,
-				                                             pct_pattern,
-				                                             buff_enc,
-				                                             n_frames);
+			turbo_dec_mode mode;
+			mode.K       = K;
+			mode.pct_en  = pct_en;
+			mode.pool    = d_make_pool(K, pct_en);
+			mode.N       = mode.pool->get_N();
+			mode.out_len = mode.pool->get_out_len();
+			mode.redec   = NULL;
+			d_modes.push_back(mode);
+
+			if (d_redec_n_ite > 0) {
+				try {
+					d_modes.back().redec = make_redecoder(d_modes.size() - 1);
+				} catch (...) {
+					delete d_modes.back().pool;
+					d_modes.pop_back();
+					throw;
+				}
 			}
+		}
 
-			/* GR Block Configurations */
-			set_fixed_rate(true);
-			set_relative_rate((double)K/(double)N);
-			set_output_multiple(K);
+		/*
+		 * Delete the modes past the first n_kept
+		 */
+		void
+		turbo_decoder_impl::drop_modes(unsigned int n_kept)
+		{
+			while (d_modes.size() > n_kept) {
+				delete d_modes.back().redec;
+				delete d_modes.back().pool;
+				d_modes.pop_back();
+			}
 		}
 
 		/*
-		 * Our virtual destructor.
+		 * GR Block Configurations. With several modes, the output buffer
+		 * must fit a codeword of any of them, and the input tags can't be
+		 * mapped to the output by a fixed rate.
 		 */
-		turbo_decoder_impl::~turbo_decoder_impl()
+		void
+		turbo_decoder_impl::configure_modes()
+		{
+			int max_out_len = 0;
+			for (auto &mode : d_modes)
+				max_out_len = std::max(max_out_len, mode.out_len);
+
+			set_fixed_rate(d_modes.size() == 1);
+			set_relative_rate((double)d_modes[0].out_len/(double)d_modes[0].N);
+			set_output_multiple(max_out_len);
+			set_tag_propagation_policy((d_modes.size() > 1) ? TPP_DONT
+			                                                : TPP_ALL_TO_ALL);
+		}
+
+		void
+		turbo_decoder_impl::set_alt_modes(const std::vector<int> &alt_K,
+		                                  const std::vector<int> &alt_pct_en)
 		{
-			volk_free(d_llr_buffer);
-			volk_free(d_int_buffer);
-			delete interleaver;
-			delete sub_enc;
-			delete sub_dec;
-			delete dec;
-			if (d_pct_en)
-				delete pct;
+			check_not_started("set_alt_modes");
+			if (alt_K.size() != alt_pct_en.size())
+				throw std::runtime_error("turbo_decoder: alt_K and alt_pct_en must have the same length");
+
+			drop_modes(1);
+			try {
+				for (unsigned int i = 0; i < alt_K.size(); i++)
+					add_mode(alt_K[i], alt_pct_en[i] != 0);
+			} catch (...) {
+				drop_modes(1);
+				configure_modes();
+				throw;
+			}
+			configure_modes();
+		}
+
+		/*
+		 * The decoding modules are only built before the flowgraph starts,
+		 * such that general_work never races with the setters
+		 */
+		void
+		turbo_decoder_impl::check_not_started(const char *setter) const
+		{
+			if (d_started)
+				throw std::runtime_error(std::string("turbo_decoder: ") +
+				                         setter + " must be called before "
+				                         "the flowgraph starts");
+		}
+
+		bool
+		turbo_decoder_impl::start()
+		{
+			d_started = true;
+			return block::start();
+		}
+
+		/*
+		 * Second-chance decoder of a mode, publishing from its own thread
+		 */
+		TurboRedecoder *
+		turbo_decoder_impl::make_redecoder(int mode)
+		{
+			const turbo_dec_mode &m = d_modes[mode];
+			return new TurboRedecoder(
+				d_redec_queue_len, m.K, m.pct_en, d_redec_n_ite, d_flip_llrs,
+				d_crc, d_pack_bits,
+				[this, mode](uint64_t offset, const unsigned char *out,
+				             int n_ite)
+				{
+					publish_recovered(d_modes[mode], offset, out, n_ite);
+				});
+		}
+
+		void
+		turbo_decoder_impl::set_redecoding(int n_ite, int queue_len)
+		{
+			check_not_started("set_redecoding");
+			if (n_ite < 0)
+				throw std::runtime_error("turbo_decoder: redec_n_ite must be >= 0");
+
+			for (auto &mode : d_modes) {
+				delete mode.redec;
+				mode.redec = NULL;
+			}
+			d_redec_n_ite     = n_ite;
+			d_redec_queue_len = queue_len;
+			if (n_ite == 0)
+				return;
+
+			try {
+				for (unsigned int i = 0; i < d_modes.size(); i++)
+					d_modes[i].redec = make_redecoder(i);
+			} catch (...) {
+				for (auto &mode : d_modes) {
+					delete mode.redec;
+					mode.redec = NULL;
+				}
+				d_redec_n_ite = 0;
+				throw;
+			}
+		}
+
+		/*
+		 * Mode matching a (K . pct_en) pair, -1 if not built
+		 */
+		int
+		turbo_decoder_impl::find_mode(const pmt::pmt_t &value) const
+		{
+			if (pmt::is_pair(value) && pmt::is_integer(pmt::car(value))) {
+				const int K       = pmt::to_long(pmt::car(value));
+				const bool pct_en = pmt::is_true(pmt::cdr(value));
+
+				for (unsigned int i = 0; i < d_modes.size(); i++) {
+					if (d_modes[i].K == K && d_modes[i].pct_en == pct_en)
+						return i;
+				}
+			}
+
+			fprintf(stderr, "turbo_decoder: ignoring unknown mode %s\n",
+			        pmt::write_string(value).c_str());
+			return -1;
+		}
+
+		void
+		turbo_decoder_impl::set_mode(int mode)
+		{
+			if (mode < 0 || mode == d_mode)
+				return;
+
+			d_mode         = mode;
+			d_mode_changed = true;
+			set_relative_rate((double)d_modes[mode].out_len /
+			                  (double)d_modes[mode].N);
+		}
+
+		/*
+		 * Applied from the next general_work call, i.e. on a codeword
+		 * boundary
+		 */
+		void
+		turbo_decoder_impl::handle_mode(pmt::pmt_t msg)
+		{
+			int mode = find_mode(msg);
+			if (mode >= 0)
+				d_msg_mode = mode;
 		}
 
 		int
@@ -144,18 +343,52 @@ namespace gr {
 			return (int)(0.5 + noutput/relative_rate());
 		}
 
+		/*
+		 * Input for the codewords of the current mode fitting the output.
+		 * If a tag switches to a longer mode, general_work stops before the
+		 * switch and the next forecast asks for the new length.
+		 */
 		void
 		turbo_decoder_impl::forecast(int noutput_items,
 		                             gr_vector_int& ninput_items_required)
 		{
-			int n_codewords          = noutput_items / d_K;
-			ninput_items_required[0] = n_codewords * d_N;
+			const turbo_dec_mode &mode = d_modes[d_mode];
+			int n_codewords            = noutput_items / mode.out_len;
+			ninput_items_required[0]   = n_codewords * mode.N;
 
 			debug_printf("%s: noutput = %d\tninput = %d\tn_codewords = %d\n",
 			             __func__, noutput_items, ninput_items_required[0],
 			             n_codewords);
 		}
 
+		/*
+		 * Decode contiguous codewords of a mode and queue the failed ones
+		 * for second-chance decoding, along with their output offset
+		 */
+		void
+		turbo_decoder_impl::decode(const turbo_dec_mode &mode,
+		                           const float *in, unsigned char *out,
+		                           int n_codewords, uint64_t out_offset)
+		{
+			unsigned char *failed = NULL;
+			if (mode.redec) {
+				if ((int)d_failed.size() < n_codewords)
+					d_failed.resize(n_codewords);
+				failed = d_failed.data();
+			}
+
+			mode.pool->decode(in, out, n_codewords, failed);
+
+			if (mode.redec) {
+				for (int i = 0; i < n_codewords; i++) {
+					if (failed[i] &&
+					    !mode.redec->push(in + i * mode.N,
+					                      out_offset + i * mode.out_len))
+						d_n_redec_dropped.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+		}
+
 		int
 		turbo_decoder_impl::general_work(int noutput_items,
 		                                 gr_vector_int& ninput_items,
@@ -165,54 +398,248 @@ namespace gr {
 
 			const float *inbuffer    = (float *)input_items[0];
 			unsigned char *outbuffer = (unsigned char *)output_items[0];
-			int n_codewords          = noutput_items / d_K;
-
-			debug_printf("%s: ninput %d\tnoutput %d\tn_codewords %d\n", __func__,
-			             ninput_items[0], noutput_items, n_codewords);
-
-			for (int i = 0; i < n_codewords; i++) {
-				if (d_flip_llrs) {
-					volk_32f_s32f_multiply_32f(d_llr_buffer,
-					                           inbuffer + (i * d_N),
-					                           -1.0f, d_N);
-					if (d_pct_en) {
-						pct->depuncture(d_llr_buffer, d_pct_buffer);
-						dec->_decode_siho(d_pct_buffer, d_int_buffer, 0);
-					} else {
-						dec->_decode_siho(d_llr_buffer, d_int_buffer, 0);
-					}
-				} else {
-					if (d_pct_en) {
-						pct->depuncture(inbuffer + (i * d_N), d_pct_buffer);
-						dec->_decode_siho(d_pct_buffer,
-						                  d_int_buffer, 0);
-					} else {
-						dec->_decode_siho(inbuffer + (i * d_N),
-						                  d_int_buffer, 0);
-					}
+			const uint64_t in_start  = nitems_read(0);
+			int n_in  = 0;
+			int n_out = 0;
+
+			debug_printf("%s: ninput %d\tnoutput %d\n", __func__,
+			             ninput_items[0], noutput_items);
+
+			if (d_msg_mode >= 0) {
+				set_mode(d_msg_mode);
+				d_msg_mode = -1;
+			}
+
+			if (d_modes.size() > 1)
+				get_tags_in_range(d_tags, 0, in_start,
+				                  in_start + ninput_items[0],
+				                  pmt::mp("turbo_mode"));
+			unsigned int i_tag = 0;
+
+			/* Decode runs of codewords of the same mode */
+			while (true) {
+				/* Tags up to the start of the next codeword */
+				while (i_tag < d_tags.size() &&
+				       d_tags[i_tag].offset <= in_start + n_in)
+					set_mode(find_mode(d_tags[i_tag++].value));
+
+				const turbo_dec_mode &mode = d_modes[d_mode];
+				int n_codewords = std::min((ninput_items[0] - n_in) / mode.N,
+				                           (noutput_items - n_out) / mode.out_len);
+
+				/* A codeword starting before the next tag is decoded in
+				 * the current mode */
+				if (i_tag < d_tags.size()) {
+					const int to_tag = d_tags[i_tag].offset - (in_start + n_in);
+					n_codewords = std::min(n_codewords,
+					                       (to_tag + mode.N - 1) / mode.N);
 				}
 
-				// Convert int output of the decoder to unsigned char
-				for (int j = 0; j < d_K; j++)
-				{
-					outbuffer[(i * d_K) + j] = (unsigned char) d_int_buffer[j];
+				if (n_codewords == 0)
+					break;
+
+				if (d_mode_changed) {
+					add_item_tag(0, nitems_written(0) + n_out,
+					             pmt::mp("turbo_mode"),
+					             pmt::cons(pmt::from_long(mode.K),
+					                       pmt::from_bool(mode.pct_en)));
+					d_mode_changed = false;
 				}
 
-#ifdef DEBUG_DEC
-				printf("dec_in = ");
-				for(int j = 0; j < d_N; j++)
-					printf("%f ", inbuffer[i * d_N + j]);
-				printf("\n");
+				decode(mode, inbuffer + n_in, outbuffer + n_out, n_codewords,
+				       nitems_written(0) + n_out);
+				n_in  += n_codewords * mode.N;
+				n_out += n_codewords * mode.out_len;
+			}
+			d_tags.clear();
 
-				printf("dec_out = ");
-				for(int j = 0; j < d_K; j++)
-					printf("%d ", outbuffer[i * d_K + j]);
-				printf("\n");
-#endif
+			/* All codecs are idle now */
+			update_stats();
+
+			const float stats_period = d_stats_period.load(std::memory_order_relaxed);
+			if (stats_period > 0 &&
+			    std::chrono::steady_clock::now() - d_last_stats >=
+			    std::chrono::duration<float>(stats_period)) {
+				publish_stats();
+				d_last_stats = std::chrono::steady_clock::now();
+			}
+
+			consume_each(n_in);
+			return n_out;
+		}
+
+		/*
+		 * Move the statistics collected from the codecs into the counters
+		 * read by the getters. Only general_work writes the counters, hence
+		 * the plain load + store of the maximum.
+		 */
+		void
+		turbo_decoder_impl::update_stats()
+		{
+			turbo_codec_stats &s = d_work_stats;
+			uint64_t n_codewords = 0;
+
+			for (auto &mode : d_modes)
+				mode.pool->collect_stats(s);
+
+			for (int i = 0; i <= d_n_ite; i++) {
+				d_ite_hist[i].fetch_add(s.ite_hist[i], std::memory_order_relaxed);
+				n_codewords += s.ite_hist[i];
+				s.ite_hist[i] = 0;
+			}
+			d_n_failures.fetch_add(s.n_failures, std::memory_order_relaxed);
+			d_time_sum_ns.fetch_add(s.time_sum_ns, std::memory_order_relaxed);
+			if (s.time_max_ns > d_time_max_ns.load(std::memory_order_relaxed))
+				d_time_max_ns.store(s.time_max_ns, std::memory_order_relaxed);
+			/* Last, such that the other counters cover these codewords */
+			d_n_codewords.fetch_add(n_codewords, std::memory_order_release);
+
+			s.n_failures  = 0;
+			s.time_sum_ns = 0;
+			s.time_max_ns = 0;
+		}
+
+		void
+		turbo_decoder_impl::publish_stats()
+		{
+			std::vector<uint64_t> hist(d_n_ite + 1);
+			for (int i = 0; i <= d_n_ite; i++)
+				hist[i] = d_ite_hist[i].load(std::memory_order_relaxed);
+
+			pmt::pmt_t msg = pmt::make_dict();
+			msg = pmt::dict_add(msg, pmt::mp("n_frames"),
+			                    pmt::from_uint64(get_n_frames()));
+			msg = pmt::dict_add(msg, pmt::mp("n_failures"),
+			                    pmt::from_uint64(get_n_failures()));
+			msg = pmt::dict_add(msg, pmt::mp("fer"),
+			                    pmt::from_double(get_fer()));
+			msg = pmt::dict_add(msg, pmt::mp("avg_iterations"),
+			                    pmt::from_double(get_avg_iterations()));
+			msg = pmt::dict_add(msg, pmt::mp("iteration_hist"),
+			                    pmt::init_u64vector(hist.size(), hist));
+			msg = pmt::dict_add(msg, pmt::mp("avg_decode_time"),
+			                    pmt::from_double(get_avg_decode_time()));
+			msg = pmt::dict_add(msg, pmt::mp("max_decode_time"),
+			                    pmt::from_double(get_max_decode_time()));
+			if (d_modes[0].redec) {
+				msg = pmt::dict_add(msg, pmt::mp("n_recovered"),
+				                    pmt::from_uint64(get_n_recovered()));
+				msg = pmt::dict_add(msg, pmt::mp("n_redec_dropped"),
+				                    pmt::from_uint64(d_n_redec_dropped.load(std::memory_order_relaxed)));
+			}
+			message_port_pub(pmt::mp("stats"), msg);
+		}
+
+		/*
+		 * Called from the second-chance decoding thread
+		 */
+		void
+		turbo_decoder_impl::publish_recovered(const turbo_dec_mode &mode,
+		                                      uint64_t offset,
+		                                      const unsigned char *out,
+		                                      int n_ite)
+		{
+			d_n_recovered.fetch_add(1, std::memory_order_relaxed);
+
+			pmt::pmt_t meta = pmt::make_dict();
+			meta = pmt::dict_add(meta, pmt::mp("offset"),
+			                     pmt::from_uint64(offset));
+			meta = pmt::dict_add(meta, pmt::mp("n_ite"),
+			                     pmt::from_long(n_ite));
+			meta = pmt::dict_add(meta, pmt::mp("K"),
+			                     pmt::from_long(mode.K));
+			message_port_pub(pmt::mp("recovered"),
+			                 pmt::cons(meta, pmt::init_u8vector(mode.out_len, out)));
+		}
+
+		void
+		turbo_decoder_impl::set_stats_period(float period)
+		{
+			if (period < 0)
+				throw std::runtime_error("turbo_decoder: stats_period must be >= 0");
+			d_stats_period.store(period, std::memory_order_relaxed);
+		}
+
+		float
+		turbo_decoder_impl::get_avg_iterations()
+		{
+			uint64_t n_codewords = 0, n_ite = 0;
+
+			for (int i = 0; i <= d_n_ite; i++) {
+				const uint64_t n = d_ite_hist[i].load(std::memory_order_relaxed);
+				n_codewords += n;
+				n_ite       += i * n;
 			}
 
-			consume_each(n_codewords * d_N);
-			return noutput_items;
+			return (n_codewords > 0) ? ((float)n_ite / n_codewords) : 0.0;
+		}
+
+		std::vector<int>
+		turbo_decoder_impl::get_iteration_hist()
+		{
+			std::vector<int> hist(d_n_ite + 1);
+			for (int i = 0; i <= d_n_ite; i++)
+				hist[i] = (int)d_ite_hist[i].load(std::memory_order_relaxed);
+			return hist;
+		}
+
+		void
+		turbo_decoder_impl::reset_stats()
+		{
+			for (int i = 0; i <= d_n_ite; i++)
+				d_ite_hist[i].store(0, std::memory_order_relaxed);
+			d_n_codewords.store(0, std::memory_order_relaxed);
+			d_n_failures.store(0, std::memory_order_relaxed);
+			d_time_sum_ns.store(0, std::memory_order_relaxed);
+			d_time_max_ns.store(0, std::memory_order_relaxed);
+			d_n_recovered.store(0, std::memory_order_relaxed);
+			d_n_redec_dropped.store(0, std::memory_order_relaxed);
+		}
+
+		float
+		turbo_decoder_impl::get_fer()
+		{
+			const uint64_t n_codewords = get_n_frames();
+			const uint64_t n_failures  = get_n_failures();
+			return (n_codewords > 0) ? ((float)n_failures / n_codewords) : 0.0;
+		}
+
+		uint64_t
+		turbo_decoder_impl::get_n_frames()
+		{
+			return d_n_codewords.load(std::memory_order_acquire);
+		}
+
+		uint64_t
+		turbo_decoder_impl::get_n_failures()
+		{
+			return d_n_failures.load(std::memory_order_relaxed);
+		}
+
+		float
+		turbo_decoder_impl::get_avg_decode_time()
+		{
+			const uint64_t n_codewords = get_n_frames();
+			const uint64_t time_sum    = d_time_sum_ns.load(std::memory_order_relaxed);
+			return (n_codewords > 0) ? ((float)time_sum / n_codewords / 1e3) : 0.0;
+		}
+
+		float
+		turbo_decoder_impl::get_max_decode_time()
+		{
+			return d_time_max_ns.load(std::memory_order_relaxed) / 1e3;
+		}
+
+		std::string
+		turbo_decoder_impl::get_simd_level()
+		{
+			return d_modes[0].pool->get_simd_level();
+		}
+
+		uint64_t
+		turbo_decoder_impl::get_n_recovered()
+		{
+			return d_n_recovered.load(std::memory_order_relaxed);
 		}
 
 	} /* namespace blocksat */
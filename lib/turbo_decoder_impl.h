@@ -22,41 +22,72 @@
 #define INCLUDED_BLOCKSAT_TURBO_DECODER_IMPL_H
 
 #include <blocksat/turbo_decoder.h>
-
-#include "Tools/types.h"
-#include "Module/Interleaver/LTE/Interleaver_LTE.hpp"
-
-#include "Module/Encoder/Turbo/Encoder_turbo.hpp"
-#include "Module/Encoder/Encoder_sys.hpp"
-#include "Module/Encoder/RSC/Encoder_RSC_generic_sys.hpp"
-
-#include "Module/Decoder/Turbo/Decoder_turbo.hpp"
-#include "Module/Decoder/RSC/BCJR/Seq/Decoder_RSC_BCJR_seq_very_fast.hpp"
-#include "Module/Decoder/Turbo/Decoder_turbo_fast.hpp"
-#include "Module/Puncturer/Turbo/Puncturer_turbo.hpp"
-
-using namespace aff3ct;
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "turbo_codec.h"
 
 namespace gr {
 	namespace blocksat {
 
+		/* Pre-built decoding modules of a codeword length and rate */
+		struct turbo_dec_mode {
+			int K;
+			bool pct_en;
+			int N;
+			int out_len; /* output bytes per codeword */
+			TurboCodecPool *pool;
+			TurboRedecoder *redec; /* NULL without second-chance decoding */
+		};
+
 		class turbo_decoder_impl : public turbo_decoder
 		{
 		private:
-			// Nothing to declare in this block.
-			module::Encoder_RSC_generic_sys<B_8> *sub_enc;
-			module::Decoder_RSC_BCJR_seq_very_fast
-			<int,float,float,tools::max<float>,tools::max<float>> * sub_dec;
-			module::Interleaver_LTE<int> *interleaver;
-			module::Decoder_turbo_fast<int, float> *dec;
-			module::Puncturer_turbo<int,float> *pct;
-			float *d_llr_buffer;
-			int *d_int_buffer;
+			std::vector<turbo_dec_mode> d_modes; /* [0] is the initial mode */
+			int d_mode;     /* mode of the next codeword */
+			int d_msg_mode; /* mode requested by message (-1 if none) */
+			bool d_mode_changed; /* tag the next output codeword */
+			std::vector<tag_t> d_tags;
+			std::vector<unsigned char> d_failed; /* per codeword of a call */
+			int d_n_ite;
 			bool d_flip_llrs;
-			int d_N;
-			int d_K;
-			bool d_pct_en;
-			float *d_pct_buffer;
+			std::string d_crc;
+			bool d_pack_bits;
+			int d_redec_n_ite;     /* 0 without second-chance decoding */
+			int d_redec_queue_len;
+			bool d_started; /* the modes and decoders can't change anymore */
+			std::function<TurboCodecPool*(int K, bool pct_en)> d_make_pool;
+
+			/* Statistics: written by general_work only, read by the getters
+			 * without locking */
+			turbo_codec_stats d_work_stats; /* collected after each call */
+			std::unique_ptr<std::atomic<uint64_t>[]> d_ite_hist; /* codewords per n. of iterations */
+			std::atomic<uint64_t> d_n_codewords;
+			std::atomic<uint64_t> d_n_failures;
+			std::atomic<uint64_t> d_time_sum_ns;
+			std::atomic<uint64_t> d_time_max_ns;
+			std::atomic<uint64_t> d_n_recovered;
+			std::atomic<uint64_t> d_n_redec_dropped;
+			std::atomic<float> d_stats_period; /* seconds between stats messages */
+			std::chrono::steady_clock::time_point d_last_stats;
+
+			void add_mode(int K, bool pct_en);
+			void drop_modes(unsigned int n_kept);
+			void configure_modes();
+			void check_not_started(const char *setter) const;
+			TurboRedecoder *make_redecoder(int mode);
+			void update_stats();
+			void publish_stats();
+			void publish_recovered(const turbo_dec_mode &mode, uint64_t offset,
+			                       const unsigned char *out, int n_ite);
+			int find_mode(const pmt::pmt_t &value) const;
+			void set_mode(int mode);
+			void handle_mode(pmt::pmt_t msg);
+			void decode(const turbo_dec_mode &mode, const float *in,
+			            unsigned char *out, int n_codewords,
+			            uint64_t out_offset);
 
 		public:
 			/*!
@@ -65,8 +96,26 @@ namespace gr {
 			 * \param pct_en Enable depuncturer
 			 * \param n_ite maximum number of iterations
 			 * \param flip_llrs Invert the sign of the input LLRs
+			 * \param inter_frame Decode one codeword per SIMD lane
+			 * \param n_threads Number of decoding threads
+			 * \param precision Bits per LLR inside the decoder (32 or 16)
+			 * \param crc CRC polynomial for early termination ("" to disable)
+			 * \param window_len Sliding-window BCJR window (0 to disable)
+			 * \param training_len Sliding-window BCJR training length
+			 * \param n_sub_blocks Sub-blocks decoded in parallel per trellis
+			 * \param radix4 Use the radix-4 BCJR
+			 * \param pack_bits Output 8 bits per byte
+			 * \param max_op BCJR max operator (max, max_star or max_linear)
+			 * \param ext_scale Extrinsic LLR scaling factor
+			 * \param hd_stop Stop once the hard decisions are stable
 			 */
-			turbo_decoder_impl(int K, bool pct_en, int n_ite, bool flip_llrs);
+			turbo_decoder_impl(int K, bool pct_en, int n_ite, bool flip_llrs,
+			                   bool inter_frame, int n_threads, int precision,
+			                   const std::string &crc, int window_len,
+			                   int training_len, int n_sub_blocks,
+			                   bool radix4, bool pack_bits,
+			                   const std::string &max_op, float ext_scale,
+			                   bool hd_stop);
 			~turbo_decoder_impl();
 
 			// Where all the action really happens
@@ -81,6 +130,22 @@ namespace gr {
 			int fixed_rate_noutput_to_ninput(int noutput);
 			void forecast(int noutput_items,
 			              gr_vector_int& ninput_items_required);
+			bool start();
+
+			void set_stats_period(float period);
+			void set_redecoding(int n_ite, int queue_len);
+			void set_alt_modes(const std::vector<int> &alt_K,
+			                   const std::vector<int> &alt_pct_en);
+			float get_avg_iterations();
+			std::vector<int> get_iteration_hist();
+			void reset_stats();
+			std::string get_simd_level();
+			float get_fer();
+			uint64_t get_n_frames();
+			uint64_t get_n_failures();
+			float get_avg_decode_time();
+			float get_max_decode_time();
+			uint64_t get_n_recovered();
 
 		};
 
@@ -88,4 +153,3 @@ namespace gr {
 } // namespace gr
 
 #endif /* INCLUDED_BLOCKSAT_TURBO_DECODER_IMPL_H */
-
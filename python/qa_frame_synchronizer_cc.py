@@ -95,6 +95,254 @@ class qa_frame_synchronizer_cc (gr_unittest.TestCase):
             self.assertFloatTuplesAlmostEqual (expected_res[1:frame_len],
                                                res_sym_out[1:frame_len], 6)
 
+    def test_002_t (self):
+        """Long preamble, for which the PMF uses FFT fast convolution"""
+        # Parameters
+        preamble_len      = 64
+        payload_len       = 136
+        frame_len         = preamble_len + payload_len
+        M                 = 4
+        n_success_to_lock = 1
+        n_frames          = 10
+
+        np.random.seed(1)
+        qpsk        = np.array([1+1j, -1+1j, -1-1j, 1-1j]) / np.sqrt(2)
+        preamble    = qpsk[np.random.randint(0, 4, preamble_len)]
+        rx_frame    = np.concatenate((preamble,
+                                      qpsk[np.random.randint(0, 4, payload_len)]))
+        expected_res = tuple(repmat(rx_frame, 1, n_frames - n_success_to_lock)[0])
+
+        # PMF taps, as set by the block: preceded by preamble_len zeros
+        pmf_taps = np.concatenate((np.zeros(preamble_len),
+                                   np.conj(preamble[::-1])))
+
+        for n_silence in range(0, frame_len, 23):
+            silence_syms = 0.0001 * np.ones(n_silence, np.complex64)
+            rx_syms      = np.concatenate((silence_syms,
+                                           tuple(repmat(rx_frame, 1, n_frames)[0])))
+
+            # Flowgraph
+            sym_src            = blocks.vector_source_c(rx_syms)
+            frame_synchronizer = blocksat.frame_synchronizer_cc(tuple(preamble),
+                                                                frame_len,
+                                                                M,
+                                                                n_success_to_lock,
+                                                                False, False,
+                                                                False, 0)
+            sym_snk            = blocks.vector_sink_c ()
+            pmf_snk            = blocks.vector_sink_c ()
+            self.tb = gr.top_block ()
+            self.tb.connect(sym_src, (frame_synchronizer, 0))
+            self.tb.connect((frame_synchronizer, 0), sym_snk)
+            self.tb.connect((frame_synchronizer, 1), pmf_snk)
+            self.tb.run()
+
+            # Frames are aligned after locking
+            res_sym_out = sym_snk.data()
+            self.assertFloatTuplesAlmostEqual (expected_res[1:frame_len],
+                                               res_sym_out[1:frame_len], 5)
+
+            # PMF output of the first frame matches the direct convolution
+            pmf_ref = np.convolve(rx_syms, pmf_taps)[:frame_len]
+            self.assertComplexTuplesAlmostEqual (tuple(pmf_ref),
+                                                 pmf_snk.data()[:frame_len], 3)
+
+    def test_003_t (self):
+        """A corrupted preamble delays the lock by a single frame"""
+        # Parameters
+        preamble_len      = 64
+        payload_len       = 136
+        frame_len         = preamble_len + payload_len
+        M                 = 4
+        n_success_to_lock = 3
+        n_frames          = 10
+        n_silence         = 37
+        i_corrupted       = 1
+
+        np.random.seed(2)
+        qpsk        = np.array([1+1j, -1+1j, -1-1j, 1-1j]) / np.sqrt(2)
+        preamble    = qpsk[np.random.randint(0, 4, preamble_len)]
+        rx_frame    = np.concatenate((preamble,
+                                      qpsk[np.random.randint(0, 4, payload_len)]))
+        silence_syms = 0.0001 * np.ones(n_silence, np.complex64)
+        rx_syms      = np.concatenate((silence_syms,
+                                       tuple(repmat(rx_frame, 1, n_frames)[0])))
+
+        # Replace the preamble of one of the frames used for locking
+        i_start = n_silence + i_corrupted * frame_len
+        rx_syms[i_start:i_start + preamble_len] = \
+            qpsk[np.random.randint(0, 4, preamble_len)]
+
+        # Flowgraph
+        sym_src            = blocks.vector_source_c(rx_syms)
+        frame_synchronizer = blocksat.frame_synchronizer_cc(tuple(preamble),
+                                                            frame_len,
+                                                            M,
+                                                            n_success_to_lock,
+                                                            False, False,
+                                                            False, 0)
+        sym_snk            = blocks.vector_sink_c ()
+        self.tb.connect(sym_src, (frame_synchronizer, 0))
+        self.tb.connect((frame_synchronizer, 0), sym_snk)
+        self.tb.run()
+
+        # The first frame seeds the frame start, the corrupted one is
+        # missed and, on a clean signal, the next one completes the lock.
+        # Previously, the corrupted frame restarted the acquisition.
+        n_lock_frames = 3
+        self.assertEqual(frame_synchronizer.get_time_to_lock(),
+                         n_silence + (n_lock_frames - 1) * frame_len)
+
+        # Frames are aligned after locking
+        expected_res = tuple(repmat(rx_frame, 1, n_frames - n_lock_frames + 1)[0])
+        self.assertFloatTuplesAlmostEqual (expected_res, sym_snk.data(), 5)
+
+    def test_004_t (self):
+        """The confirmations needed to lock scale with the PMF peak quality"""
+        # Parameters
+        preamble_len      = 64
+        payload_len       = 136
+        frame_len         = preamble_len + payload_len
+        M                 = 4
+        n_success_to_lock = 5
+        n_frames          = 12
+        n_silence         = 37
+
+        np.random.seed(3)
+        qpsk        = np.array([1+1j, -1+1j, -1-1j, 1-1j]) / np.sqrt(2)
+        preamble    = qpsk[np.random.randint(0, 4, preamble_len)]
+        rx_frame    = np.concatenate((preamble,
+                                      qpsk[np.random.randint(0, 4, payload_len)]))
+        silence_syms = 0.0001 * np.ones(n_silence, np.complex64)
+        tx_syms      = np.concatenate((silence_syms,
+                                       tuple(repmat(rx_frame, 1, n_frames)[0])))
+
+        time_to_lock = []
+        for esn0_db in [20, -6]:
+            noise_std = np.sqrt(0.5 * 10**(-esn0_db / 10.0))
+            rx_syms   = tx_syms + noise_std * (
+                np.random.randn(len(tx_syms)) +
+                1j * np.random.randn(len(tx_syms)))
+
+            # Flowgraph
+            sym_src            = blocks.vector_source_c(rx_syms)
+            frame_synchronizer = blocksat.frame_synchronizer_cc(tuple(preamble),
+                                                                frame_len,
+                                                                M,
+                                                                n_success_to_lock,
+                                                                False, False,
+                                                                False, 0)
+            sym_snk            = blocks.vector_sink_c ()
+            self.tb = gr.top_block ()
+            self.tb.connect(sym_src, (frame_synchronizer, 0))
+            self.tb.connect((frame_synchronizer, 0), sym_snk)
+            self.tb.run()
+
+            # Frames are aligned after locking
+            i_lock = frame_synchronizer.get_time_to_lock()
+            self.assertEqual((i_lock - n_silence) % frame_len, 0)
+            self.assertComplexTuplesAlmostEqual (
+                tuple(rx_syms[i_lock:i_lock + frame_len]),
+                sym_snk.data()[:frame_len], 5)
+            time_to_lock.append(i_lock)
+
+        # A single confirmation on a clean signal, more at low SNR, and no
+        # more than n_success_to_lock while the peak is found
+        self.assertEqual(time_to_lock[0], n_silence + frame_len)
+        self.assertGreater(time_to_lock[1], time_to_lock[0])
+        self.assertLessEqual(time_to_lock[1],
+                             n_silence + n_success_to_lock * frame_len)
+
+    def test_005_t (self):
+        """Lock is lost after n_success_to_lock frames without the preamble"""
+        # Parameters
+        preamble_len      = 64
+        payload_len       = 136
+        frame_len         = preamble_len + payload_len
+        M                 = 4
+        n_success_to_lock = 3
+        n_clean           = 4
+        n_silence         = 37
+
+        np.random.seed(4)
+        qpsk     = np.array([1+1j, -1+1j, -1-1j, 1-1j]) / np.sqrt(2)
+        preamble = qpsk[np.random.randint(0, 4, preamble_len)]
+
+        def frames(n, with_preamble=True):
+            syms = []
+            for i in range(n):
+                syms.append(preamble if with_preamble
+                            else np.zeros(preamble_len, np.complex64))
+                syms.append(qpsk[np.random.randint(0, 4, payload_len)])
+            return np.concatenate(syms)
+
+        # Drop the preamble after lock. The trailing frame lets the block
+        # process the last frame without the preamble.
+        for n_dropped in range(0, n_success_to_lock + 1):
+            silence_syms = 0.0001 * np.ones(n_silence, np.complex64)
+            rx_syms      = np.concatenate((silence_syms, frames(n_clean),
+                                           frames(n_dropped, False),
+                                           frames(1)))
+
+            # Flowgraph
+            sym_src            = blocks.vector_source_c(rx_syms)
+            frame_synchronizer = blocksat.frame_synchronizer_cc(tuple(preamble),
+                                                                frame_len,
+                                                                M,
+                                                                n_success_to_lock,
+                                                                False, False,
+                                                                False, 0)
+            sym_snk            = blocks.vector_sink_c ()
+            self.tb = gr.top_block ()
+            self.tb.connect(sym_src, (frame_synchronizer, 0))
+            self.tb.connect((frame_synchronizer, 0), sym_snk)
+            self.tb.run()
+
+            self.assertEqual(frame_synchronizer.get_time_to_lock(),
+                             n_silence + frame_len)
+            self.assertEqual(frame_synchronizer.get_state(),
+                             n_dropped < n_success_to_lock)
+
+    def test_006_t (self):
+        """Without the fast lock, lock takes n_success_to_lock confirmations"""
+        # Parameters
+        preamble_len      = 64
+        payload_len       = 136
+        frame_len         = preamble_len + payload_len
+        M                 = 4
+        n_success_to_lock = 3
+        n_frames          = 6
+        n_silence         = 37
+
+        np.random.seed(5)
+        qpsk        = np.array([1+1j, -1+1j, -1-1j, 1-1j]) / np.sqrt(2)
+        preamble    = qpsk[np.random.randint(0, 4, preamble_len)]
+        rx_frame    = np.concatenate((preamble,
+                                      qpsk[np.random.randint(0, 4, payload_len)]))
+        silence_syms = 0.0001 * np.ones(n_silence, np.complex64)
+        rx_syms      = np.concatenate((silence_syms,
+                                       tuple(repmat(rx_frame, 1, n_frames)[0])))
+
+        for fast_lock in [True, False]:
+            # Flowgraph
+            sym_src            = blocks.vector_source_c(rx_syms)
+            frame_synchronizer = blocksat.frame_synchronizer_cc(tuple(preamble),
+                                                                frame_len,
+                                                                M,
+                                                                n_success_to_lock,
+                                                                False, False,
+                                                                False, 0)
+            frame_synchronizer.set_fast_lock(fast_lock)
+            sym_snk            = blocks.vector_sink_c ()
+            self.tb = gr.top_block ()
+            self.tb.connect(sym_src, (frame_synchronizer, 0))
+            self.tb.connect((frame_synchronizer, 0), sym_snk)
+            self.tb.run()
+
+            n_confirmations = 1 if fast_lock else n_success_to_lock
+            self.assertEqual(frame_synchronizer.get_time_to_lock(),
+                             n_silence + n_confirmations * frame_len)
+
 
 if __name__ == '__main__':
     gr_unittest.run(qa_frame_synchronizer_cc, "qa_frame_synchronizer_cc.xml")
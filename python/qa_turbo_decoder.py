@@ -24,6 +24,8 @@ from gnuradio import blocks
 from numpy import array
 import random
 import math
+import time
+import pmt
 import blocksat_swig as blocksat
 import blocksattx
 
@@ -216,6 +218,717 @@ class qa_turbo_decoder (gr_unittest.TestCase):
         # Check results
         self.assertEqual(sum(err), 0)
 
+    def test_004_t (self):
+        """Inter-frame decoding - noisy BPSK w/ partial last batch"""
+
+        # Parameters
+        K           = 6144
+        pct_en      = False
+        n_ite       = 6
+        M           = 2
+        snr_db      = SNR_DB
+        flip_llrs   = False
+        inter_frame = True
+
+        # NOTE: use a number of codewords that is not a multiple of any SIMD
+        # width, such that the last batch is always partial and has to be
+        # flushed by the decoder.
+        max_len     = 19*K
+
+        # Constants
+        noise_v = 1/math.sqrt((10**(float(snr_db)/10)))
+        rndm = random.Random()
+
+        # Input data
+        in_vec  = tuple([rndm.randint(0,1) for i in range(0, max_len)])
+
+        # Flowgraph
+        src     = blocks.vector_source_b(in_vec)
+        enc     = blocksattx.turbo_encoder(K, pct_en)
+        const   = digital.constellation_bpsk().base()
+        cmap    = digital.chunks_to_symbols_bc(const.points())
+        nadder  = blocks.add_cc()
+        noise   = analog.noise_source_c(analog.GR_GAUSSIAN, noise_v, 0)
+        cdemap  = blocksat.soft_decoder_cf(M, noise_v)
+        dec     = blocksat.turbo_decoder(K, pct_en, n_ite, flip_llrs,
+                                         inter_frame)
+        snk     = blocks.vector_sink_b()
+        self.tb.connect(src, enc, cmap)
+        self.tb.connect(cmap, (nadder, 0))
+        self.tb.connect(noise, (nadder, 1))
+        self.tb.connect(nadder, cdemap, dec, snk)
+        self.tb.run()
+
+        # Collect results
+        out_vec = snk.data ()
+        diff    = array(in_vec) - array(out_vec)
+        err     = [0 if i == 0 else 1 for i in diff]
+
+        print('Number of errors: %d' %(sum(err)))
+
+        # Check results
+        self.assertEqual(len(out_vec), len(in_vec))
+        self.assertEqual(sum(err), 0)
+
+    def test_005_t (self):
+        """Multi-threaded decoding - noisy BPSK - output order"""
+
+        # Parameters
+        K           = 6144
+        pct_en      = False
+        n_ite       = 6
+        M           = 2
+        snr_db      = SNR_DB
+        flip_llrs   = False
+        inter_frame = False
+        n_threads   = 3
+        max_len     = 10*K
+
+        # Constants
+        noise_v = 1/math.sqrt((10**(float(snr_db)/10)))
+        rndm = random.Random()
+
+        # Input data
+        in_vec  = tuple([rndm.randint(0,1) for i in range(0, max_len)])
+
+        # Flowgraph
+        src     = blocks.vector_source_b(in_vec)
+        enc     = blocksattx.turbo_encoder(K, pct_en)
+        const   = digital.constellation_bpsk().base()
+        cmap    = digital.chunks_to_symbols_bc(const.points())
+        nadder  = blocks.add_cc()
+        noise   = analog.noise_source_c(analog.GR_GAUSSIAN, noise_v, 0)
+        cdemap  = blocksat.soft_decoder_cf(M, noise_v)
+        dec     = blocksat.turbo_decoder(K, pct_en, n_ite, flip_llrs,
+                                         inter_frame, n_threads)
+        snk     = blocks.vector_sink_b()
+        self.tb.connect(src, enc, cmap)
+        self.tb.connect(cmap, (nadder, 0))
+        self.tb.connect(noise, (nadder, 1))
+        self.tb.connect(nadder, cdemap, dec, snk)
+        self.tb.run()
+
+        # Collect results
+        out_vec = snk.data ()
+        diff    = array(in_vec) - array(out_vec)
+        err     = [0 if i == 0 else 1 for i in diff]
+
+        print('Number of errors: %d' %(sum(err)))
+
+        # Check results (any reordering of codewords would cause errors)
+        self.assertEqual(len(out_vec), len(in_vec))
+        self.assertEqual(sum(err), 0)
+
+    def _require_fixed_point(self):
+        """Skip the test if the SIMD level has no fixed-point kernels"""
+        level = blocksat.turbo_decoder(6144, False, 6, False).get_simd_level()
+        if level in ("sse2", "generic"):
+            self.skipTest("no fixed-point kernels at SIMD level " + level)
+
+    def _fixed_point_test(self, precision):
+        """Inter-frame fixed-point decoding - noisy QPSK"""
+
+        # Parameters
+        K           = 6144
+        pct_en      = False
+        n_ite       = 6
+        M           = 4
+        snr_db      = SNR_DB
+        flip_llrs   = False
+        inter_frame = True
+        n_threads   = 1
+        max_len     = 10*K
+
+        # Fixed-point decoding requires SSE4.1 or later SIMD extensions. On
+        # any other level, the decoder must be constructed.
+        self._require_fixed_point()
+        dec = blocksat.turbo_decoder(K, pct_en, n_ite, flip_llrs,
+                                     inter_frame, n_threads, precision)
+
+        # Constants
+        noise_v = 1/math.sqrt((10**(float(snr_db)/10)))
+        rndm    = random.Random()
+
+        # Input data
+        in_vec  = tuple([rndm.randint(0,1) for i in range(0, max_len)])
+
+        # Flowgraph
+        src     = blocks.vector_source_b(in_vec)
+        enc     = blocksattx.turbo_encoder(K, pct_en)
+        pack    = blocks.repack_bits_bb(1, 2, "", False, gr.GR_MSB_FIRST)
+        const   = digital.constellation_qpsk().base()
+        cmap    = digital.chunks_to_symbols_bc(const.points())
+        nadder  = blocks.add_cc()
+        noise   = analog.noise_source_c(analog.GR_GAUSSIAN, noise_v, 0)
+        cdemap  = blocksat.soft_decoder_cf(M, noise_v)
+        snk     = blocks.vector_sink_b()
+        self.tb.connect(src, enc, pack, cmap)
+        self.tb.connect(cmap, (nadder, 0))
+        self.tb.connect(noise, (nadder, 1))
+        self.tb.connect(nadder, cdemap, dec, snk)
+        self.tb.run()
+
+        # Collect results
+        out_vec = snk.data ()
+        diff    = array(in_vec) - array(out_vec)
+        err     = [0 if i == 0 else 1 for i in diff]
+
+        print('Number of errors: %d' %(sum(err)))
+
+        # Check results
+        self.assertEqual(sum(err), 0)
+
+    def test_006_t (self):
+        """16-bit fixed-point decoding"""
+        self._fixed_point_test(16)
+
+    def test_007_t (self):
+        """Unsupported precisions are rejected"""
+        for precision in (8, 64):
+            with self.assertRaises(RuntimeError):
+                blocksat.turbo_decoder(6144, False, 6, False, True, 1,
+                                       precision)
+
+    def _crc24a(self, bits):
+        """CRC-24A (LTE) of a list of bits, MSB first"""
+        reg = 0
+        for b in bits:
+            fb  = ((reg >> 23) & 1) ^ b
+            reg = ((reg << 1) & 0xFFFFFF) ^ (0x864CFB if fb else 0)
+        return [(reg >> (23 - i)) & 1 for i in range(24)]
+
+    def test_008_t (self):
+        """CRC-aided early termination - noisy BPSK"""
+
+        # Parameters
+        K           = 6144
+        pct_en      = False
+        n_ite       = 8
+        M           = 2
+        snr_db      = SNR_DB
+        flip_llrs   = False
+        inter_frame = False
+        n_threads   = 1
+        precision   = 32
+        n_codewords = 10
+
+        # Constants
+        noise_v = 1/math.sqrt((10**(float(snr_db)/10)))
+        rndm = random.Random()
+
+        # Input data: the last 24 bits of each dataword carry the CRC
+        in_vec = []
+        for i in range(0, n_codewords):
+            data    = [rndm.randint(0,1) for j in range(0, K - 24)]
+            in_vec += data + self._crc24a(data)
+        in_vec = tuple(in_vec)
+
+        # Flowgraph
+        src     = blocks.vector_source_b(in_vec)
+        enc     = blocksattx.turbo_encoder(K, pct_en)
+        const   = digital.constellation_bpsk().base()
+        cmap    = digital.chunks_to_symbols_bc(const.points())
+        nadder  = blocks.add_cc()
+        noise   = analog.noise_source_c(analog.GR_GAUSSIAN, noise_v, 0)
+        cdemap  = blocksat.soft_decoder_cf(M, noise_v)
+        dec     = blocksat.turbo_decoder(K, pct_en, n_ite, flip_llrs,
+                                         inter_frame, n_threads, precision,
+                                         "24-LTEA")
+        snk     = blocks.vector_sink_b()
+        self.tb.connect(src, enc, cmap)
+        self.tb.connect(cmap, (nadder, 0))
+        self.tb.connect(noise, (nadder, 1))
+        self.tb.connect(nadder, cdemap, dec, snk)
+        self.tb.run()
+
+        # Collect results
+        out_vec = snk.data ()
+        diff    = array(in_vec) - array(out_vec)
+        err     = [0 if i == 0 else 1 for i in diff]
+        hist    = dec.get_iteration_hist()
+
+        print('Number of errors: %d' %(sum(err)))
+        print('Average iterations: %f' %(dec.get_avg_iterations()))
+
+        # Check results
+        self.assertEqual(sum(err), 0)
+        self.assertEqual(len(hist), n_ite + 1)
+        self.assertEqual(sum(hist), n_codewords)
+        self.assertLess(dec.get_avg_iterations(), n_ite)
+
+    def test_009_t (self):
+        """Sliding-window BCJR - noisy BPSK"""
+
+        # Parameters
+        K           = 6144
+        pct_en      = False
+        n_ite       = 6
+        n_codewords = 10
+        rndm = random.Random()
+
+        # Input data and LLRs
+        in_vec = tuple([rndm.randint(0,1) for i in range(0, n_codewords*K)])
+        llrs   = self._llrs(in_vec, K, pct_en, SNR_DB)
+
+        # Decode with the full-trellis BCJR and the sliding-window BCJR
+        out_full = self._decode(llrs, K, pct_en, n_ite)
+        out_win  = self._decode(llrs, K, pct_en, n_ite, window_len=64,
+                                training_len=32)
+
+        print('Codeword errors: %d' %(self._frame_errors(in_vec, out_win, K)))
+
+        # Check results
+        self.assertEqual(self._frame_errors(in_vec, out_full, K), 0)
+        self.assertEqual(self._frame_errors(in_vec, out_win, K), 0)
+
+        # A single window spanning the whole trellis is the full-trellis BCJR
+        for window_len in [K, 2*K]:
+            out_one = self._decode(llrs, K, pct_en, n_ite,
+                                   window_len=window_len)
+            self.assertEqual(out_one, out_full)
+
+    def test_010_t (self):
+        """Sub-block parallel BCJR - noisy BPSK"""
+
+        # Parameters
+        K           = 6144
+        pct_en      = False
+        n_ite       = 6
+        n_codewords = 10
+        rndm = random.Random()
+
+        # Input data and LLRs
+        in_vec = tuple([rndm.randint(0,1) for i in range(0, n_codewords*K)])
+        llrs   = self._llrs(in_vec, K, pct_en, SNR_DB)
+
+        # Decode the whole trellis at once and in sub-blocks
+        out_one = self._decode(llrs, K, pct_en, n_ite)
+        out_sub = self._decode(llrs, K, pct_en, n_ite, n_sub_blocks=4)
+
+        print('Codeword errors: %d' %(self._frame_errors(in_vec, out_sub, K)))
+
+        # Check results: at high SNR, the sub-block boundary metrics
+        # estimated over the iterations don't change any decision
+        self.assertEqual(self._frame_errors(in_vec, out_sub, K), 0)
+        self.assertEqual(out_sub, out_one)
+
+    def test_011_t (self):
+        """Radix-4 BCJR - noisy BPSK"""
+
+        # Parameters
+        K           = 1024
+        pct_en      = False
+        n_ite       = 6
+        n_codewords = 20
+        snr_db      = -4.3 # Eb/N0 of about 0.5 dB
+        rndm = random.Random()
+
+        # Input data and LLRs
+        in_vec  = tuple([rndm.randint(0,1) for i in range(0, n_codewords*K)])
+        llrs    = self._llrs(in_vec, K, pct_en, SNR_DB)
+        llrs_lo = self._llrs(in_vec, K, pct_en, snr_db)
+
+        # Radix-4 decoding at high SNR
+        out_r2 = self._decode(llrs, K, pct_en, n_ite)
+        out_r4 = self._decode(llrs, K, pct_en, n_ite, radix4=True)
+
+        print('Codeword errors: %d' %(self._frame_errors(in_vec, out_r4, K)))
+
+        self.assertEqual(self._frame_errors(in_vec, out_r4, K), 0)
+        self.assertEqual(out_r4, out_r2)
+
+        # With the max operator, merging two stages only reorders the
+        # additions of the path metrics, which is exact with integers: the
+        # fixed-point radix-4 BCJR matches the radix-2 BCJR bit by bit, even
+        # with many decoding errors. Floats may round differently.
+        self._require_fixed_point()
+        out_r2 = self._decode(llrs_lo, K, pct_en, n_ite, precision=16)
+        out_r4 = self._decode(llrs_lo, K, pct_en, n_ite, precision=16,
+                              radix4=True)
+
+        print('Codeword errors at %.1f dB: %d' %(
+            snr_db, self._frame_errors(in_vec, out_r2, K)))
+
+        self.assertGreater(self._frame_errors(in_vec, out_r2, K), 0)
+        self.assertEqual(out_r4, out_r2)
+
+    def test_012_t (self):
+        """Packed output - noisy BPSK"""
+
+        # Parameters
+        K           = 6144
+        pct_en      = False
+        n_ite       = 6
+        n_codewords = 10
+        rndm = random.Random()
+
+        # Input data and LLRs
+        in_vec = tuple([rndm.randint(0,1) for i in range(0, n_codewords*K)])
+        llrs   = self._llrs(in_vec, K, pct_en, SNR_DB)
+
+        # Decode with one bit per byte and packed (unpacked by _decode)
+        out_bits   = self._decode(llrs, K, pct_en, n_ite)
+        out_packed = self._decode(llrs, K, pct_en, n_ite, pack_bits=True)
+
+        print('Codeword errors: %d' %(
+            self._frame_errors(in_vec, out_packed, K)))
+
+        # Check results
+        self.assertEqual(self._frame_errors(in_vec, out_packed, K), 0)
+        self.assertEqual(out_packed, out_bits)
+
+    def test_013_t (self):
+        """Log-MAP BCJR and extrinsic scaling - noisy BPSK"""
+
+        # Parameters
+        K           = 1024
+        pct_en      = False
+        n_ite       = 6
+        n_codewords = 40
+        snr_db      = -4.3 # Eb/N0 of about 0.5 dB
+        rndm = random.Random()
+
+        # Input data and LLRs at a marginal SNR
+        in_vec = tuple([rndm.randint(0,1) for i in range(0, n_codewords*K)])
+        llrs   = self._llrs(in_vec, K, pct_en, snr_db)
+
+        # The exact Jacobian logarithm decodes more codewords than the
+        # max-log approximation
+        fer = {}
+        for max_op in ["max", "max_star"]:
+            out_vec     = self._decode(llrs, K, pct_en, n_ite, max_op=max_op)
+            fer[max_op] = self._frame_errors(in_vec, out_vec, K)
+            print('%s: %d codeword errors' %(max_op, fer[max_op]))
+
+        self.assertLess(fer["max_star"], fer["max"])
+
+        # Log-MAP with scaled extrinsic LLRs at high SNR
+        llrs    = self._llrs(in_vec, K, pct_en, SNR_DB)
+        out_vec = self._decode(llrs, K, pct_en, n_ite, max_op="max_star",
+                               ext_scale=0.75)
+        self.assertEqual(self._frame_errors(in_vec, out_vec, K), 0)
+
+    def test_014_t (self):
+        """SIMD level of the decoding kernels"""
+
+        dec = blocksat.turbo_decoder(6144, False, 6, False)
+        level = dec.get_simd_level()
+        print('SIMD level: %s' %(level))
+
+        self.assertIn(level, ["avx512", "avx2", "sse4.1", "sse2", "generic"])
+
+    def test_015_t (self):
+        """Inter-frame early termination on stable hard decisions, lane by
+        lane - noisy BPSK"""
+
+        # Parameters
+        K           = 1024
+        pct_en      = False
+        n_ite       = 8
+        M           = 2
+        snr_db      = SNR_DB
+        flip_llrs   = False
+        inter_frame = True
+        n_threads   = 1
+        precision   = 32
+        hd_stop     = True
+        n_codewords = 20
+
+        # Constants
+        noise_v = 1/math.sqrt((10**(float(snr_db)/10)))
+        rndm = random.Random()
+
+        # Input data
+        in_vec  = tuple([rndm.randint(0,1) for i in range(0, n_codewords*K)])
+
+        # Flowgraph
+        src     = blocks.vector_source_b(in_vec)
+        enc     = blocksattx.turbo_encoder(K, pct_en)
+        const   = digital.constellation_bpsk().base()
+        cmap    = digital.chunks_to_symbols_bc(const.points())
+        nadder  = blocks.add_cc()
+        noise   = analog.noise_source_c(analog.GR_GAUSSIAN, noise_v, 0)
+        cdemap  = blocksat.soft_decoder_cf(M, noise_v)
+        dec     = blocksat.turbo_decoder(K, pct_en, n_ite, flip_llrs,
+                                         inter_frame, n_threads, precision,
+                                         "", 0, 32, 1, False, False, "max",
+                                         1.0, hd_stop)
+        snk     = blocks.vector_sink_b()
+        self.tb.connect(src, enc, cmap)
+        self.tb.connect(cmap, (nadder, 0))
+        self.tb.connect(noise, (nadder, 1))
+        self.tb.connect(nadder, cdemap, dec, snk)
+        self.tb.run()
+
+        # Collect results
+        out_vec = snk.data ()
+        diff    = array(in_vec) - array(out_vec)
+        err     = [0 if i == 0 else 1 for i in diff]
+        hist    = dec.get_iteration_hist()
+
+        print('Number of errors: %d' %(sum(err)))
+        print('Average iterations: %f' %(dec.get_avg_iterations()))
+
+        # Check results
+        self.assertEqual(sum(err), 0)
+        self.assertEqual(sum(hist), n_codewords)
+        self.assertLess(dec.get_avg_iterations(), n_ite)
+
+    def test_016_t (self):
+        """Decoding statistics with CRC - noisy BPSK"""
+
+        # Parameters
+        K           = 1024
+        pct_en      = False
+        n_ite       = 8
+        M           = 2
+        snr_db      = SNR_DB
+        flip_llrs   = False
+        inter_frame = False
+        n_threads   = 1
+        precision   = 32
+        n_codewords = 10
+
+        # Constants
+        noise_v = 1/math.sqrt((10**(float(snr_db)/10)))
+        rndm = random.Random()
+
+        # Input data: the last 24 bits of each dataword carry the CRC
+        in_vec = []
+        for i in range(0, n_codewords):
+            data    = [rndm.randint(0,1) for j in range(0, K - 24)]
+            in_vec += data + self._crc24a(data)
+        in_vec = tuple(in_vec)
+
+        # Flowgraph
+        src     = blocks.vector_source_b(in_vec)
+        enc     = blocksattx.turbo_encoder(K, pct_en)
+        const   = digital.constellation_bpsk().base()
+        cmap    = digital.chunks_to_symbols_bc(const.points())
+        nadder  = blocks.add_cc()
+        noise   = analog.noise_source_c(analog.GR_GAUSSIAN, noise_v, 0)
+        cdemap  = blocksat.soft_decoder_cf(M, noise_v)
+        dec     = blocksat.turbo_decoder(K, pct_en, n_ite, flip_llrs,
+                                         inter_frame, n_threads, precision,
+                                         "24-LTEA")
+        snk     = blocks.vector_sink_b()
+        self.tb.connect(src, enc, cmap)
+        self.tb.connect(cmap, (nadder, 0))
+        self.tb.connect(noise, (nadder, 1))
+        self.tb.connect(nadder, cdemap, dec, snk)
+        self.tb.run()
+
+        print('Frames: %d' %(dec.get_n_frames()))
+        print('FER: %f' %(dec.get_fer()))
+        print('Decoding time: %f us avg, %f us max' %(
+            dec.get_avg_decode_time(), dec.get_max_decode_time()))
+
+        # Check results
+        self.assertEqual(dec.get_n_frames(), n_codewords)
+        self.assertEqual(dec.get_n_failures(), 0)
+        self.assertEqual(dec.get_fer(), 0)
+        self.assertGreater(dec.get_avg_decode_time(), 0)
+        self.assertGreaterEqual(dec.get_max_decode_time(),
+                                dec.get_avg_decode_time())
+
+        # Reset
+        dec.reset_stats()
+        self.assertEqual(dec.get_n_frames(), 0)
+        self.assertEqual(sum(dec.get_iteration_hist()), 0)
+
+    def test_017_t (self):
+        """Second-chance decoding of the codewords failing the CRC"""
+
+        # Parameters
+        K            = 1024
+        pct_en       = False
+        n_ite        = 1
+        M            = 2
+        snr_db       = -3
+        flip_llrs    = False
+        inter_frame  = False
+        n_threads    = 1
+        precision    = 32
+        redec_n_ite  = 16
+        n_codewords  = 10
+
+        # Constants
+        noise_v = 1/math.sqrt((10**(float(snr_db)/10)))
+        rndm = random.Random()
+
+        # Input data: the last 24 bits of each dataword carry the CRC
+        in_vec = []
+        for i in range(0, n_codewords):
+            data    = [rndm.randint(0,1) for j in range(0, K - 24)]
+            in_vec += data + self._crc24a(data)
+        in_vec = tuple(in_vec)
+
+        # Flowgraph
+        src     = blocks.vector_source_b(in_vec)
+        enc     = blocksattx.turbo_encoder(K, pct_en)
+        const   = digital.constellation_bpsk().base()
+        cmap    = digital.chunks_to_symbols_bc(const.points())
+        nadder  = blocks.add_cc()
+        noise   = analog.noise_source_c(analog.GR_GAUSSIAN, noise_v, 0)
+        cdemap  = blocksat.soft_decoder_cf(M, noise_v)
+        dec     = blocksat.turbo_decoder(K, pct_en, n_ite, flip_llrs,
+                                         inter_frame, n_threads, precision,
+                                         "24-LTEA")
+        dec.set_redecoding(redec_n_ite, n_codewords)
+        snk     = blocks.vector_sink_b()
+        self.tb.connect(src, enc, cmap)
+        self.tb.connect(cmap, (nadder, 0))
+        self.tb.connect(noise, (nadder, 1))
+        self.tb.connect(nadder, cdemap, dec, snk)
+        self.tb.run()
+
+        # The second-chance decoding runs in the background
+        for i in range(0, 100):
+            if (dec.get_n_recovered() > 0):
+                break
+            time.sleep(0.1)
+
+        print('Online failures: %d' %(dec.get_n_failures()))
+        print('Recovered: %d' %(dec.get_n_recovered()))
+
+        # Check results
+        self.assertGreater(dec.get_n_failures(), 0)
+        self.assertGreater(dec.get_n_recovered(), 0)
+        self.assertLessEqual(dec.get_n_recovered(), dec.get_n_failures())
+
+    def _llrs(self, in_vec, K, pct_en, snr_db):
+        """Turbo-encode and transmit over BPSK + AWGN, return the LLRs"""
+
+        noise_v = 1/math.sqrt((10**(float(snr_db)/10)))
+        tb      = gr.top_block()
+        src     = blocks.vector_source_b(in_vec)
+        enc     = blocksattx.turbo_encoder(K, pct_en)
+        const   = digital.constellation_bpsk().base()
+        cmap    = digital.chunks_to_symbols_bc(const.points())
+        nadder  = blocks.add_cc()
+        noise   = analog.noise_source_c(analog.GR_GAUSSIAN, noise_v, 0)
+        cdemap  = blocksat.soft_decoder_cf(2, noise_v)
+        snk     = blocks.vector_sink_f()
+        tb.connect(src, enc, cmap)
+        tb.connect(cmap, (nadder, 0))
+        tb.connect(noise, (nadder, 1))
+        tb.connect(nadder, cdemap, snk)
+        tb.run()
+        return snk.data()
+
+    def _decode(self, llrs, K, pct_en, n_ite, precision=32, window_len=0,
+                training_len=32, n_sub_blocks=1, radix4=False,
+                pack_bits=False, max_op="max", ext_scale=1.0):
+        """Decode the LLRs in intra-frame mode, return the decoded bits"""
+
+        tb      = gr.top_block()
+        src     = blocks.vector_source_f(llrs)
+        dec     = blocksat.turbo_decoder(K, pct_en, n_ite, False, False, 1,
+                                         precision, "", window_len,
+                                         training_len, n_sub_blocks, radix4,
+                                         pack_bits, max_op, ext_scale)
+        snk     = blocks.vector_sink_b()
+        if (pack_bits):
+            unpack = blocks.packed_to_unpacked_bb(1, gr.GR_MSB_FIRST)
+            tb.connect(src, dec, unpack, snk)
+        else:
+            tb.connect(src, dec, snk)
+        tb.run()
+        return snk.data()
+
+    def _frame_errors(self, in_vec, out_vec, K):
+        """Number of codewords decoded with errors"""
+
+        self.assertEqual(len(out_vec), len(in_vec))
+        return sum([1 if in_vec[i:i+K] != out_vec[i:i+K] else 0
+                    for i in range(0, len(in_vec), K)])
+
+    def test_018_t (self):
+        """Codeword length and rate switched by a stream tag"""
+
+        # Parameters
+        K_1         = 1024
+        pct_en_1    = False
+        K_2         = 2048
+        pct_en_2    = True
+        n_ite       = 6
+        n_cw_1      = 3
+        n_cw_2      = 2
+        rndm = random.Random()
+
+        # Input data and LLRs of each mode
+        in_vec_1 = tuple([rndm.randint(0,1) for i in range(0, n_cw_1*K_1)])
+        in_vec_2 = tuple([rndm.randint(0,1) for i in range(0, n_cw_2*K_2)])
+        llrs_1   = self._llrs(in_vec_1, K_1, pct_en_1, SNR_DB)
+        llrs_2   = self._llrs(in_vec_2, K_2, pct_en_2, SNR_DB)
+
+        # The second mode starts with a tag on its first LLR
+        tag        = gr.tag_t()
+        tag.offset = len(llrs_1)
+        tag.key    = pmt.intern("turbo_mode")
+        tag.value  = pmt.cons(pmt.from_long(K_2), pmt.from_bool(pct_en_2))
+
+        # Flowgraph
+        src     = blocks.vector_source_f(llrs_1 + llrs_2, False, 1, [tag])
+        dec     = blocksat.turbo_decoder(K_1, pct_en_1, n_ite, False)
+        dec.set_alt_modes([K_2], [pct_en_2])
+        snk     = blocks.vector_sink_b()
+        self.tb.connect(src, dec, snk)
+        self.tb.run()
+
+        # Collect results
+        in_vec  = in_vec_1 + in_vec_2
+        out_vec = snk.data ()
+        diff    = array(in_vec) - array(out_vec)
+        err     = [0 if i == 0 else 1 for i in diff]
+        tags    = [t for t in snk.tags()
+                   if pmt.symbol_to_string(t.key) == "turbo_mode"]
+
+        print('Number of errors: %d' %(sum(err)))
+
+        # Check results
+        self.assertEqual(len(out_vec), len(in_vec))
+        self.assertEqual(sum(err), 0)
+        self.assertEqual(dec.get_n_frames(), n_cw_1 + n_cw_2)
+        self.assertEqual(len(tags), 1)
+        self.assertEqual(tags[0].offset, len(in_vec_1))
+
+    def test_019_t (self):
+        """Codeword lengths not filling the widest SIMD registers"""
+
+        # Parameters
+        pct_en      = False
+        n_ite       = 6
+        snr_db      = 3
+        n_codewords = 10
+        rndm = random.Random()
+
+        # K = 8 (mod 16) doesn't fit 16 float lanes (AVX-512), in which case
+        # the decoder falls back to a narrower SIMD level
+        for K in [40, 504]:
+            in_vec = tuple([rndm.randint(0,1) for i in range(0, n_codewords*K)])
+            llrs   = self._llrs(in_vec, K, pct_en, snr_db)
+
+            # Flowgraph
+            self.tb = gr.top_block()
+            src     = blocks.vector_source_f(llrs)
+            dec     = blocksat.turbo_decoder(K, pct_en, n_ite, False)
+            snk     = blocks.vector_sink_b()
+            self.tb.connect(src, dec, snk)
+            self.tb.run()
+
+            # Collect results
+            out_vec = snk.data ()
+            diff    = array(in_vec) - array(out_vec)
+            err     = [0 if i == 0 else 1 for i in diff]
+
+            print('K = %d, SIMD level: %s, number of errors: %d' %(
+                K, dec.get_simd_level(), sum(err)))
+
+            # Check results
+            self.assertEqual(len(out_vec), len(in_vec))
+            self.assertEqual(sum(err), 0)
+
 
 if __name__ == '__main__':
     gr_unittest.run(qa_turbo_decoder, "qa_turbo_decoder.xml")